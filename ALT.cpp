@@ -0,0 +1,317 @@
+#include "ALT.h"
+#include <iostream>
+#include <fstream>
+#include <limits>
+#include <queue>
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+    // 地标文件的魔数和版本
+    const char ALT_FILE_MAGIC[4] = {'A', 'L', 'T', '2'};
+
+    // 建立距离表时的权重参数：参数改变后time和balanced_score随之改变，旧的距离表可能高估距离，
+    // 启发函数不再是下界，A*会返回错误的路径，因此参数不同时视为无效
+    struct AltWeightParameters
+    {
+        double bpr_alpha;
+        double bpr_beta;
+        double lane_capacity;
+        double time_factor;
+        double distance_factor;
+    };
+
+    AltWeightParameters current_weight_parameters()
+    {
+        return AltWeightParameters{BPRConfig::alpha, BPRConfig::beta, BPRConfig::lane_capacity,
+                                   PathWeightConfig::time_factor, PathWeightConfig::distance_factor};
+    }
+
+    // 三种权重模式，下标与 from_landmark/to_landmark 一致
+    const WeightMode ALL_MODES[3] = {WeightMode::TIME, WeightMode::DISTANCE, WeightMode::BALANCED};
+}
+
+ALTEngine::ALTEngine(const Graph &graph) : graph(graph)
+{
+}
+
+// 选取地标并计算距离表
+void ALTEngine::build(size_t landmark_count)
+{
+    select_landmarks(landmark_count);
+
+    size_t n = graph.node_count();
+    size_t k = landmarks.size();
+
+    for (int m = 0; m < 3; ++m)
+    {
+        from_landmark[m].assign(n * k, std::numeric_limits<double>::infinity());
+        to_landmark[m].assign(n * k, std::numeric_limits<double>::infinity());
+
+        for (size_t i = 0; i < k; ++i)
+        {
+            store_column(from_landmark[m], i, k, graph.shortest_distances(landmarks[i], ALL_MODES[m], false));
+            store_column(to_landmark[m], i, k, graph.shortest_distances(landmarks[i], ALL_MODES[m], true));
+        }
+    }
+}
+
+// 最远点策略：每次选取与已选地标往返距离最远的节点作为新地标
+// 与所有已选地标都不连通的节点距离为无穷大，会被优先选中，从而覆盖不同的连通区域
+void ALTEngine::select_landmarks(size_t count)
+{
+    landmarks.clear();
+
+    size_t n = graph.node_count();
+    if (n == 0)
+    {
+        return;
+    }
+    count = std::min(count, n);
+
+    // closeness[v]：v与已选地标之间最小的往返距离
+    // 先用节点0初始化，使第一个地标落在离节点0最远的地方，而不是节点0本身
+    std::vector<double> closeness(n, std::numeric_limits<double>::infinity());
+    std::vector<bool> chosen(n, false);
+    uint32_t seed = 0;
+
+    while (landmarks.size() < count)
+    {
+        std::vector<double> forward = graph.shortest_distances(seed, WeightMode::DISTANCE, false);
+        std::vector<double> backward = graph.shortest_distances(seed, WeightMode::DISTANCE, true);
+        for (size_t v = 0; v < n; ++v)
+        {
+            closeness[v] = std::min(closeness[v], forward[v] + backward[v]);
+        }
+
+        // 选取最远的未选节点
+        uint32_t farthest = Graph::INVALID_ID;
+        for (size_t v = 0; v < n; ++v)
+        {
+            if (!chosen[v] && (farthest == Graph::INVALID_ID || closeness[v] > closeness[farthest]))
+            {
+                farthest = static_cast<uint32_t>(v);
+            }
+        }
+
+        chosen[farthest] = true;
+        landmarks.push_back(farthest);
+        seed = farthest;
+    }
+}
+
+// 把单源距离写入距离表的第index列
+void ALTEngine::store_column(std::vector<double> &table, size_t index, size_t stride,
+                             const std::vector<double> &distances)
+{
+    for (size_t v = 0; v < distances.size(); ++v)
+    {
+        table[v * stride + index] = distances[v];
+    }
+}
+
+// 从文件加载地标距离表
+// 格式：魔数 | 节点数 | 边数 | 权重参数 | 地标数K | K个地标ID | 按模式依次存放 from 表和 to 表
+bool ALTEngine::load(const std::string &filename)
+{
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open())
+    {
+        return false;
+    }
+
+    char magic[4];
+    uint32_t node_total = 0, edge_total = 0, k = 0;
+    AltWeightParameters parameters{};
+    file.read(magic, sizeof(magic));
+    file.read(reinterpret_cast<char *>(&node_total), sizeof(node_total));
+    file.read(reinterpret_cast<char *>(&edge_total), sizeof(edge_total));
+    file.read(reinterpret_cast<char *>(&parameters), sizeof(parameters));
+    file.read(reinterpret_cast<char *>(&k), sizeof(k));
+
+    // 校验文件是否属于当前图和当前的权重参数
+    AltWeightParameters current = current_weight_parameters();
+    if (!file || std::memcmp(magic, ALT_FILE_MAGIC, sizeof(magic)) != 0 ||
+        node_total != graph.node_count() || edge_total != graph.edge_count() || k > node_total ||
+        parameters.bpr_alpha != current.bpr_alpha || parameters.bpr_beta != current.bpr_beta ||
+        parameters.lane_capacity != current.lane_capacity || parameters.time_factor != current.time_factor ||
+        parameters.distance_factor != current.distance_factor)
+    {
+        return false;
+    }
+
+    landmarks.resize(k);
+    file.read(reinterpret_cast<char *>(landmarks.data()), k * sizeof(uint32_t));
+
+    size_t table_size = static_cast<size_t>(node_total) * k;
+    for (int m = 0; m < 3; ++m)
+    {
+        from_landmark[m].resize(table_size);
+        to_landmark[m].resize(table_size);
+        file.read(reinterpret_cast<char *>(from_landmark[m].data()), table_size * sizeof(double));
+        file.read(reinterpret_cast<char *>(to_landmark[m].data()), table_size * sizeof(double));
+    }
+
+    // 地标ID越界说明文件损坏
+    bool landmarks_valid = std::all_of(landmarks.begin(), landmarks.end(),
+                                       [node_total](uint32_t landmark) { return landmark < node_total; });
+    if (!file || !landmarks_valid)
+    {
+        // 文件被截断或损坏，丢弃已读入的部分
+        landmarks.clear();
+        for (int m = 0; m < 3; ++m)
+        {
+            from_landmark[m].clear();
+            to_landmark[m].clear();
+        }
+        return false;
+    }
+
+    return true;
+}
+
+// 将地标距离表保存到文件
+bool ALTEngine::save(const std::string &filename) const
+{
+    std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+    if (!file.is_open())
+    {
+        std::cerr << "Error: Could not save landmark tables to " << filename << std::endl;
+        return false;
+    }
+
+    uint32_t node_total = static_cast<uint32_t>(graph.node_count());
+    uint32_t edge_total = static_cast<uint32_t>(graph.edge_count());
+    uint32_t k = static_cast<uint32_t>(landmarks.size());
+    AltWeightParameters parameters = current_weight_parameters();
+
+    file.write(ALT_FILE_MAGIC, sizeof(ALT_FILE_MAGIC));
+    file.write(reinterpret_cast<const char *>(&node_total), sizeof(node_total));
+    file.write(reinterpret_cast<const char *>(&edge_total), sizeof(edge_total));
+    file.write(reinterpret_cast<const char *>(&parameters), sizeof(parameters));
+    file.write(reinterpret_cast<const char *>(&k), sizeof(k));
+    file.write(reinterpret_cast<const char *>(landmarks.data()), k * sizeof(uint32_t));
+
+    for (int m = 0; m < 3; ++m)
+    {
+        file.write(reinterpret_cast<const char *>(from_landmark[m].data()), from_landmark[m].size() * sizeof(double));
+        file.write(reinterpret_cast<const char *>(to_landmark[m].data()), to_landmark[m].size() * sizeof(double));
+    }
+
+    return static_cast<bool>(file);
+}
+
+// 使用A*查找最短路径
+PathResult ALTEngine::find_shortest_path(uint32_t source, uint32_t target, WeightMode mode) const
+{
+    const int m = static_cast<int>(mode);
+    const size_t n = graph.node_count();
+    const size_t k = landmarks.size();
+    const double infinity = std::numeric_limits<double>::infinity();
+
+    const double *weight = graph.weights(mode).data();
+    const std::vector<uint32_t> &offsets = graph.get_offsets();
+    const std::vector<uint32_t> &targets = graph.get_edge_targets();
+
+    // 终点与各地标之间的距离，对每个节点计算启发函数时都要用到
+    const double *target_from = from_landmark[m].data() + target * k;
+    const double *target_to = to_landmark[m].data() + target * k;
+
+    // 启发函数：所有地标给出的下界中的最大值
+    // 两个距离都为无穷大时差值为NaN，比较结果为false，自动被忽略；
+    // 下界为无穷大说明该节点不可能到达终点
+    auto heuristic = [&](uint32_t v) {
+        const double *v_from = from_landmark[m].data() + v * k;
+        const double *v_to = to_landmark[m].data() + v * k;
+        double h = 0.0;
+        for (size_t i = 0; i < k; ++i)
+        {
+            double forward_bound = target_from[i] - v_from[i];
+            double backward_bound = v_to[i] - target_to[i];
+            if (forward_bound > h)
+                h = forward_bound;
+            if (backward_bound > h)
+                h = backward_bound;
+        }
+        return h;
+    };
+
+    // 队列元素：<f = g + h, 节点ID>
+    using QElement = std::pair<double, uint32_t>;
+    std::priority_queue<QElement, std::vector<QElement>, std::greater<QElement>> pq;
+
+    std::vector<double> distances(n, infinity);          // g值
+    std::vector<double> estimates(n, -1.0);              // 缓存的h值，-1表示尚未计算
+    std::vector<uint32_t> predecessors(n, Graph::INVALID_ID);
+
+    PathResult result;
+    estimates[source] = heuristic(source);
+    if (estimates[source] == infinity)
+    {
+        return result;  // 由地标距离可知终点不可达
+    }
+
+    distances[source] = 0;
+    pq.push({estimates[source], source});
+    size_t settled = 0;
+
+    while (!pq.empty())
+    {
+        double current_f = pq.top().first;
+        uint32_t current_node = pq.top().second;
+        pq.pop();
+
+        double current_dist = distances[current_node];
+        if (current_f > current_dist + estimates[current_node])
+        {
+            continue;  // 作废的记录
+        }
+        settled++;
+
+        if (current_node == target)
+        {
+            break;
+        }
+
+        for (uint32_t e = offsets[current_node]; e < offsets[current_node + 1]; ++e)
+        {
+            uint32_t neighbor = targets[e];
+            double new_dist = current_dist + weight[e];
+
+            if (new_dist < distances[neighbor])
+            {
+                if (estimates[neighbor] < 0)
+                {
+                    estimates[neighbor] = heuristic(neighbor);
+                }
+                if (estimates[neighbor] == infinity)
+                {
+                    continue;  // 剪枝：从该邻居出发无法到达终点
+                }
+
+                distances[neighbor] = new_dist;
+                predecessors[neighbor] = e;
+                pq.push({new_dist + estimates[neighbor], neighbor});
+            }
+        }
+    }
+
+    if (predecessors[target] == Graph::INVALID_ID)
+    {
+        result.settled_nodes = settled;
+        return result;
+    }
+
+    result = graph.build_path_result(source, target, predecessors);
+    result.settled_nodes = settled;
+    return result;
+}
+
+// 并行计算三种模式的最短路径
+MultiPath ALTEngine::find_multi_path(const std::string &start, const std::string &end) const
+{
+    return graph.find_multi_path(start, end, [this](uint32_t source, uint32_t target, WeightMode mode) {
+        return find_shortest_path(source, target, mode);
+    });
+}
@@ -0,0 +1,59 @@
+#ifndef ALT_H
+#define ALT_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Graph.h"
+#include "config.h"
+
+// ALT（A* + Landmarks + Triangle inequality）查询引擎
+// 地图CSV中没有坐标，无法使用几何启发函数。ALT预先选取K个地标L，
+// 对每种权重模式计算 d(L, v) 和 d(v, L)，查询时由三角不等式
+//   d(v, t) >= d(L, t) - d(L, v)
+//   d(v, t) >= d(v, L) - d(t, L)
+// 得到到终点距离的下界，作为A*的启发函数
+class ALTEngine
+{
+public:
+    // graph: 引擎建立在其上的图，必须比引擎活得更久
+    explicit ALTEngine(const Graph &graph);
+
+    // 选取landmark_count个地标，并用Dijkstra计算三种模式的正向和反向距离表
+    void build(size_t landmark_count);
+
+    // 从文件加载地标距离表，文件不存在或与当前图不匹配时返回false
+    bool load(const std::string &filename);
+
+    // 将地标距离表保存到文件，返回true表示成功
+    bool save(const std::string &filename) const;
+
+    // 使用A*查找最短路径（可以被多个线程同时调用）
+    PathResult find_shortest_path(uint32_t source, uint32_t target, WeightMode mode) const;
+
+    // 并行计算三种模式的最短路径
+    MultiPath find_multi_path(const std::string &start, const std::string &end) const;
+
+    // 地标数量
+    size_t landmark_count() const { return landmarks.size(); }
+
+private:
+    const Graph &graph;
+
+    // 地标节点ID
+    std::vector<uint32_t> landmarks;
+
+    // 距离表，按权重模式下标（TIME/DISTANCE/BALANCED）存放
+    // 节点优先布局：下标 v * K + i 为节点v与第i个地标之间的距离，计算启发函数时连续读取
+    std::vector<double> from_landmark[3];   // d(L_i, v)
+    std::vector<double> to_landmark[3];     // d(v, L_i)
+
+    // 用最远点策略选取地标（在DISTANCE模式下，与交通状况无关）
+    void select_landmarks(size_t count);
+
+    // 把以某个地标为源的单源距离写入距离表的第index列
+    static void store_column(std::vector<double> &table, size_t index, size_t stride,
+                             const std::vector<double> &distances);
+};
+
+#endif // ALT_H
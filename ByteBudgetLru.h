@@ -0,0 +1,127 @@
+#ifndef BYTE_BUDGET_LRU_H
+#define BYTE_BUDGET_LRU_H
+
+#include <cstddef>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+// 按字节预算淘汰的进程内LRU表：字符串键 -> Value（通常是指向只读对象的shared_ptr），每个条目记录估计的字节数。
+// 总字节数超过预算时从最久未使用的开始淘汰，刚放入的条目总是保留。可以被多个线程同时调用。
+// GraphRegistry和PathTreeCache共用这一实现，各自决定键、字节数估计和命中时的有效性检查
+template <typename Value>
+class ByteBudgetLru
+{
+public:
+    explicit ByteBudgetLru(size_t memory_budget)
+        : memory_budget(memory_budget), total_bytes(0), hit_count(0), insert_count(0)
+    {
+    }
+
+    // 查找key，valid(value)返回false的条目被移除；不存在或无效时返回Value{}
+    template <typename Validator>
+    Value find(const std::string &key, Validator valid)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = entries.find(key);
+        if (it == entries.end())
+        {
+            return Value{};
+        }
+
+        if (!valid(it->second.value))
+        {
+            remove(it);
+            return Value{};
+        }
+
+        lru_list.splice(lru_list.begin(), lru_list, it->second.lru_position);
+        hit_count++;
+        return it->second.value;
+    }
+
+    // 放入value，替换同一键的旧值，必要时淘汰其他条目
+    void insert(const std::string &key, Value value, size_t bytes)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = entries.find(key);
+        if (it != entries.end())
+        {
+            remove(it);
+        }
+
+        lru_list.push_front(key);
+        entries[key] = Entry{std::move(value), bytes, lru_list.begin()};
+        total_bytes += bytes;
+        insert_count++;
+
+        while (total_bytes > memory_budget && lru_list.size() > 1)
+        {
+            remove(entries.find(lru_list.back()));
+        }
+    }
+
+    void erase(const std::string &key)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = entries.find(key);
+        if (it != entries.end())
+        {
+            remove(it);
+        }
+    }
+
+    // 统计信息
+    size_t size() const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return entries.size();
+    }
+
+    size_t memory_usage() const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return total_bytes;
+    }
+
+    size_t get_hit_count() const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return hit_count;
+    }
+
+    size_t get_insert_count() const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return insert_count;
+    }
+
+private:
+    struct Entry
+    {
+        Value value;
+        size_t bytes;
+        std::list<std::string>::iterator lru_position;
+    };
+
+    size_t memory_budget;
+
+    mutable std::mutex mutex;                           // 保护以下所有成员
+    std::list<std::string> lru_list;                    // 键，前面是最近使用的
+    std::unordered_map<std::string, Entry> entries;
+    size_t total_bytes;
+    size_t hit_count;
+    size_t insert_count;
+
+    // 移除一个条目（调用方持有锁）
+    void remove(typename std::unordered_map<std::string, Entry>::iterator it)
+    {
+        total_bytes -= it->second.bytes;
+        lru_list.erase(it->second.lru_position);
+        entries.erase(it);
+    }
+};
+
+#endif // BYTE_BUDGET_LRU_H
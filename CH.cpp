@@ -0,0 +1,476 @@
+#include "CH.h"
+#include <limits>
+#include <queue>
+#include <algorithm>
+#include <thread>
+
+namespace
+{
+    // 见证搜索最多确定的节点数：超过后放弃寻找绕行路径，直接添加捷径边
+    // 这只会多加一些不必要的捷径，不影响查询结果的正确性
+    const size_t WITNESS_SETTLE_LIMIT = 500;
+
+    const WeightMode ALL_MODES[3] = {WeightMode::TIME, WeightMode::DISTANCE, WeightMode::BALANCED};
+
+    using QElement = std::pair<double, uint32_t>;
+    using MinQueue = std::priority_queue<QElement, std::vector<QElement>, std::greater<QElement>>;
+}
+
+ContractionHierarchy::ContractionHierarchy() : shortcuts(0)
+{
+}
+
+// 在graph的mode权重上进行预处理
+void ContractionHierarchy::build(const Graph &graph, WeightMode mode)
+{
+    const size_t n = graph.node_count();
+    const double infinity = std::numeric_limits<double>::infinity();
+    const std::vector<double> &weight = graph.weights(mode);
+    const std::vector<uint32_t> &offsets = graph.get_offsets();
+    const std::vector<uint32_t> &targets = graph.get_edge_targets();
+
+    arcs.clear();
+    shortcuts = 0;
+    rank.assign(n, 0);
+
+    // 收缩过程中的动态图：每个节点的出边和入边（Arc下标）
+    std::vector<std::vector<uint32_t>> out_arcs(n), in_arcs(n);
+
+    // 初始边：同一对节点之间只保留权重最小的原始边，并去掉自环
+    for (uint32_t u = 0; u < n; ++u)
+    {
+        for (uint32_t e = offsets[u]; e < offsets[u + 1]; ++e)
+        {
+            uint32_t v = targets[e];
+            if (v == u)
+            {
+                continue;
+            }
+
+            bool merged = false;
+            for (uint32_t a : out_arcs[u])
+            {
+                if (arcs[a].to == v)
+                {
+                    if (weight[e] < arcs[a].weight)
+                    {
+                        arcs[a].weight = weight[e];
+                        arcs[a].first = e;
+                    }
+                    merged = true;
+                    break;
+                }
+            }
+
+            if (!merged)
+            {
+                uint32_t id = static_cast<uint32_t>(arcs.size());
+                arcs.push_back({u, v, weight[e], e, Graph::INVALID_ID});
+                out_arcs[u].push_back(id);
+                in_arcs[v].push_back(id);
+            }
+        }
+    }
+
+    std::vector<bool> contracted(n, false);
+    std::vector<int> deleted_neighbors(n, 0);
+
+    // 见证搜索的状态，只重置被访问过的节点
+    std::vector<double> witness_dist(n, infinity);
+    std::vector<uint32_t> touched;
+
+    // 见证搜索的目标标记：需要确定距离的节点
+    std::vector<bool> is_witness_target(n, false);
+
+    // 从u出发、不经过skip、在未收缩节点上的受限Dijkstra
+    // 距离超过limit、确定的节点数超过上限或所有目标都已确定时停止
+    auto witness_search = [&](uint32_t u, uint32_t skip, double limit, size_t target_count) {
+        MinQueue pq;
+        witness_dist[u] = 0;
+        touched.push_back(u);
+        pq.push({0.0, u});
+        size_t settled = 0;
+
+        while (!pq.empty())
+        {
+            double d = pq.top().first;
+            uint32_t x = pq.top().second;
+            pq.pop();
+
+            if (d > witness_dist[x])
+            {
+                continue;
+            }
+            if (d > limit || ++settled > WITNESS_SETTLE_LIMIT)
+            {
+                break;
+            }
+            if (is_witness_target[x] && --target_count == 0)
+            {
+                break;
+            }
+
+            for (uint32_t a : out_arcs[x])
+            {
+                uint32_t y = arcs[a].to;
+                if (contracted[y] || y == skip)
+                {
+                    continue;
+                }
+                double nd = d + arcs[a].weight;
+                if (nd < witness_dist[y])
+                {
+                    if (witness_dist[y] == infinity)
+                    {
+                        touched.push_back(y);
+                    }
+                    witness_dist[y] = nd;
+                    pq.push({nd, y});
+                }
+            }
+        }
+    };
+
+    auto reset_witness = [&]() {
+        for (uint32_t x : touched)
+        {
+            witness_dist[x] = infinity;
+        }
+        touched.clear();
+    };
+
+    // 添加捷径边u -> w；若已有更长的u -> w边则直接改写它，避免重复边使度数膨胀
+    auto add_shortcut = [&](uint32_t u, uint32_t w, double via_v, uint32_t in, uint32_t out) {
+        for (uint32_t a : out_arcs[u])
+        {
+            if (arcs[a].to == w)
+            {
+                if (via_v < arcs[a].weight)
+                {
+                    arcs[a].weight = via_v;
+                    arcs[a].first = in;
+                    arcs[a].second = out;
+                }
+                return;
+            }
+        }
+
+        uint32_t id = static_cast<uint32_t>(arcs.size());
+        arcs.push_back({u, w, via_v, in, out});
+        out_arcs[u].push_back(id);
+        in_arcs[w].push_back(id);
+        shortcuts++;
+    };
+
+    // 收缩节点v（apply为false时只模拟），返回需要添加的捷径边数量
+    // live_degree输出v在剩余图中的入度与出度之和
+    auto contract = [&](uint32_t v, bool apply, int &live_degree) {
+        std::vector<uint32_t> live_in, live_out;
+        for (uint32_t a : in_arcs[v])
+        {
+            if (!contracted[arcs[a].from])
+                live_in.push_back(a);
+        }
+        for (uint32_t a : out_arcs[v])
+        {
+            if (!contracted[arcs[a].to])
+                live_out.push_back(a);
+        }
+        live_degree = static_cast<int>(live_in.size() + live_out.size());
+
+        int needed = 0;
+        for (uint32_t in : live_in)
+        {
+            uint32_t u = arcs[in].from;
+
+            // 只需搜索到经过v的最长候选路径为止
+            double limit = 0.0;
+            size_t target_count = 0;
+            for (uint32_t out : live_out)
+            {
+                uint32_t w = arcs[out].to;
+                if (w != u && !is_witness_target[w])
+                {
+                    is_witness_target[w] = true;
+                    target_count++;
+                }
+                if (w != u)
+                    limit = std::max(limit, arcs[in].weight + arcs[out].weight);
+            }
+
+            witness_search(u, v, limit, target_count);
+
+            for (uint32_t out : live_out)
+            {
+                is_witness_target[arcs[out].to] = false;
+            }
+
+            for (uint32_t out : live_out)
+            {
+                uint32_t w = arcs[out].to;
+                if (w == u)
+                {
+                    continue;
+                }
+
+                double via_v = arcs[in].weight + arcs[out].weight;
+                if (witness_dist[w] <= via_v)
+                {
+                    continue;  // 存在不经过v且不更长的见证路径
+                }
+
+                needed++;
+                if (apply)
+                {
+                    add_shortcut(u, w, via_v, in, out);
+                }
+            }
+
+            reset_witness();
+        }
+        return needed;
+    };
+
+    // 优先级 = 边差（需要添加的捷径数 - 删除的边数）+ 已收缩的邻居数（使收缩在图中均匀分布）
+    auto priority = [&](uint32_t v) {
+        int live_degree = 0;
+        int needed = contract(v, false, live_degree);
+        return needed - live_degree + deleted_neighbors[v];
+    };
+
+    // 惰性更新：弹出优先级最小的节点后重新计算，若已不再最小则放回队列
+    using PElement = std::pair<int, uint32_t>;
+    std::priority_queue<PElement, std::vector<PElement>, std::greater<PElement>> order_queue;
+    for (uint32_t v = 0; v < n; ++v)
+    {
+        order_queue.push({priority(v), v});
+    }
+
+    uint32_t next_rank = 0;
+    while (!order_queue.empty())
+    {
+        uint32_t v = order_queue.top().second;
+        order_queue.pop();
+
+        int current = priority(v);
+        if (!order_queue.empty() && current > order_queue.top().first)
+        {
+            order_queue.push({current, v});
+            continue;
+        }
+
+        int live_degree = 0;
+        contract(v, true, live_degree);
+        contracted[v] = true;
+        rank[v] = next_rank++;
+
+        // 从邻居的边表中删除与v相连的边，剩余图只包含未收缩的节点
+        for (uint32_t a : in_arcs[v])
+        {
+            uint32_t u = arcs[a].from;
+            deleted_neighbors[u]++;
+            out_arcs[u].erase(std::find(out_arcs[u].begin(), out_arcs[u].end(), a));
+        }
+        for (uint32_t a : out_arcs[v])
+        {
+            uint32_t w = arcs[a].to;
+            deleted_neighbors[w]++;
+            in_arcs[w].erase(std::find(in_arcs[w].begin(), in_arcs[w].end(), a));
+        }
+        in_arcs[v].clear();
+        out_arcs[v].clear();
+    }
+
+    // 构建向上的CSR图
+    up_offsets.assign(n + 1, 0);
+    down_offsets.assign(n + 1, 0);
+    for (const Arc &arc : arcs)
+    {
+        if (rank[arc.from] < rank[arc.to])
+            up_offsets[arc.from + 1]++;
+        else
+            down_offsets[arc.to + 1]++;
+    }
+    for (size_t i = 0; i < n; ++i)
+    {
+        up_offsets[i + 1] += up_offsets[i];
+        down_offsets[i + 1] += down_offsets[i];
+    }
+
+    up_arcs.resize(up_offsets[n]);
+    down_arcs.resize(down_offsets[n]);
+    std::vector<uint32_t> up_cursor(up_offsets.begin(), up_offsets.end() - 1);
+    std::vector<uint32_t> down_cursor(down_offsets.begin(), down_offsets.end() - 1);
+    for (uint32_t a = 0; a < arcs.size(); ++a)
+    {
+        if (rank[arcs[a].from] < rank[arcs[a].to])
+            up_arcs[up_cursor[arcs[a].from]++] = a;
+        else
+            down_arcs[down_cursor[arcs[a].to]++] = a;
+    }
+}
+
+// 查询最短路径
+// 正向搜索从source沿向上的出边前进，反向搜索从target沿向上的入边后退，
+// 最短路径上层次最高的节点会被两侧都确定；某一侧队首距离不小于best时该侧即可停止
+bool ContractionHierarchy::query(uint32_t source, uint32_t target, std::vector<uint32_t> &edge_path, size_t &settled) const
+{
+    const size_t n = rank.size();
+    const double infinity = std::numeric_limits<double>::infinity();
+
+    MinQueue pq[2];
+    std::vector<double> distances[2] = {std::vector<double>(n, infinity), std::vector<double>(n, infinity)};
+    std::vector<uint32_t> predecessors[2] = {std::vector<uint32_t>(n, Graph::INVALID_ID),
+                                             std::vector<uint32_t>(n, Graph::INVALID_ID)};
+
+    distances[0][source] = 0;
+    distances[1][target] = 0;
+    pq[0].push({0.0, source});
+    pq[1].push({0.0, target});
+
+    double best = infinity;
+    uint32_t meeting = Graph::INVALID_ID;
+    settled = 0;
+
+    while (true)
+    {
+        bool forward_active = !pq[0].empty() && pq[0].top().first < best;
+        bool backward_active = !pq[1].empty() && pq[1].top().first < best;
+        if (!forward_active && !backward_active)
+        {
+            break;
+        }
+
+        int side = (forward_active && (!backward_active || pq[0].top().first <= pq[1].top().first)) ? 0 : 1;
+        double current_dist = pq[side].top().first;
+        uint32_t current_node = pq[side].top().second;
+        pq[side].pop();
+
+        if (current_dist > distances[side][current_node])
+        {
+            continue;
+        }
+        settled++;
+
+        // 两侧在当前节点交汇
+        double through = current_dist + distances[1 - side][current_node];
+        if (through < best)
+        {
+            best = through;
+            meeting = current_node;
+        }
+
+        if (side == 0)
+        {
+            for (uint32_t i = up_offsets[current_node]; i < up_offsets[current_node + 1]; ++i)
+            {
+                const Arc &arc = arcs[up_arcs[i]];
+                double new_dist = current_dist + arc.weight;
+                if (new_dist < distances[0][arc.to])
+                {
+                    distances[0][arc.to] = new_dist;
+                    predecessors[0][arc.to] = up_arcs[i];
+                    pq[0].push({new_dist, arc.to});
+                }
+            }
+        }
+        else
+        {
+            for (uint32_t i = down_offsets[current_node]; i < down_offsets[current_node + 1]; ++i)
+            {
+                const Arc &arc = arcs[down_arcs[i]];
+                double new_dist = current_dist + arc.weight;
+                if (new_dist < distances[1][arc.from])
+                {
+                    distances[1][arc.from] = new_dist;
+                    predecessors[1][arc.from] = down_arcs[i];
+                    pq[1].push({new_dist, arc.from});
+                }
+            }
+        }
+    }
+
+    if (meeting == Graph::INVALID_ID)
+    {
+        return false;
+    }
+
+    // 组装CH上的路径：source -> meeting 的正向部分和 meeting -> target 的反向部分
+    std::vector<uint32_t> arc_path;
+    for (uint32_t x = meeting; x != source; x = arcs[predecessors[0][x]].from)
+    {
+        arc_path.push_back(predecessors[0][x]);
+    }
+    std::reverse(arc_path.begin(), arc_path.end());
+    for (uint32_t x = meeting; x != target; x = arcs[predecessors[1][x]].to)
+    {
+        arc_path.push_back(predecessors[1][x]);
+    }
+
+    edge_path.clear();
+    for (uint32_t arc : arc_path)
+    {
+        unpack(arc, edge_path);
+    }
+    return true;
+}
+
+// 把Arc递归展开为原图的边序列（用显式栈代替递归）
+void ContractionHierarchy::unpack(uint32_t arc, std::vector<uint32_t> &edge_path) const
+{
+    std::vector<uint32_t> stack = {arc};
+    while (!stack.empty())
+    {
+        uint32_t a = stack.back();
+        stack.pop_back();
+
+        if (arcs[a].second == Graph::INVALID_ID)
+        {
+            edge_path.push_back(arcs[a].first);
+        }
+        else
+        {
+            // 先压入第二段，保证第一段先被展开
+            stack.push_back(arcs[a].second);
+            stack.push_back(arcs[a].first);
+        }
+    }
+}
+
+CHEngine::CHEngine(const Graph &graph) : graph(graph)
+{
+}
+
+// 并行预处理三种模式的收缩层次
+void CHEngine::build()
+{
+    std::thread time_worker([this]() { hierarchies[0].build(graph, ALL_MODES[0]); });
+    std::thread distance_worker([this]() { hierarchies[1].build(graph, ALL_MODES[1]); });
+    hierarchies[2].build(graph, ALL_MODES[2]);
+
+    time_worker.join();
+    distance_worker.join();
+}
+
+// 查询最短路径
+PathResult CHEngine::find_shortest_path(uint32_t source, uint32_t target, WeightMode mode) const
+{
+    std::vector<uint32_t> edge_path;
+    size_t settled = 0;
+
+    PathResult result;
+    if (hierarchies[static_cast<int>(mode)].query(source, target, edge_path, settled))
+    {
+        result = graph.build_path_result(source, edge_path);
+    }
+    result.settled_nodes = settled;
+    return result;
+}
+
+// 并行计算三种模式的最短路径
+MultiPath CHEngine::find_multi_path(const std::string &start, const std::string &end) const
+{
+    return graph.find_multi_path(start, end, [this](uint32_t source, uint32_t target, WeightMode mode) {
+        return find_shortest_path(source, target, mode);
+    });
+}
@@ -0,0 +1,81 @@
+#ifndef CH_H
+#define CH_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Graph.h"
+#include "config.h"
+
+// 单一权重模式下的收缩层次（Contraction Hierarchies）
+// 预处理：按边差（edge difference）确定节点顺序，依次收缩节点，
+//         当见证搜索找不到更短的绕行路径时添加捷径边（shortcut）
+// 查询：  在"向上"的图上做双向Dijkstra，两侧都只走向更高层次的节点
+// 捷径边记录它替代的两条子边，查询结果可以递归展开为原图的边序列
+class ContractionHierarchy
+{
+public:
+    ContractionHierarchy();
+
+    // 在graph的mode权重上进行预处理
+    void build(const Graph &graph, WeightMode mode);
+
+    // 查询最短路径，返回原图的边ID序列（从source出发），不可达时返回false
+    // settled: 输出两侧搜索确定的节点总数
+    bool query(uint32_t source, uint32_t target, std::vector<uint32_t> &edge_path, size_t &settled) const;
+
+    // 预处理添加的捷径边数量
+    size_t shortcut_count() const { return shortcuts; }
+
+private:
+    // 收缩层次中的一条边（原始边或捷径边）
+    struct Arc
+    {
+        uint32_t from;
+        uint32_t to;
+        double weight;
+        uint32_t first;     // 原始边：原图中的边ID；捷径边：第一段子边的Arc下标
+        uint32_t second;    // 原始边：INVALID_ID；捷径边：第二段子边的Arc下标
+    };
+
+    std::vector<Arc> arcs;
+    std::vector<uint32_t> rank;     // 节点的收缩顺序，越大层次越高
+    size_t shortcuts;
+
+    // 向上的CSR图
+    // 正向搜索：节点u的出边中目标层次更高的边 up_arcs[up_offsets[u], up_offsets[u + 1])
+    // 反向搜索：节点v的入边中起点层次更高的边 down_arcs[down_offsets[v], down_offsets[v + 1])
+    std::vector<uint32_t> up_offsets;
+    std::vector<uint32_t> up_arcs;
+    std::vector<uint32_t> down_offsets;
+    std::vector<uint32_t> down_arcs;
+
+    // 把Arc递归展开为原图的边序列
+    void unpack(uint32_t arc, std::vector<uint32_t> &edge_path) const;
+};
+
+// 三种权重模式的收缩层次
+class CHEngine
+{
+public:
+    // graph: 引擎建立在其上的图，必须比引擎活得更久
+    explicit CHEngine(const Graph &graph);
+
+    // 并行预处理三种模式的收缩层次
+    void build();
+
+    // 查询最短路径（可以被多个线程同时调用）
+    PathResult find_shortest_path(uint32_t source, uint32_t target, WeightMode mode) const;
+
+    // 并行计算三种模式的最短路径
+    MultiPath find_multi_path(const std::string &start, const std::string &end) const;
+
+    // 指定模式添加的捷径边数量
+    size_t shortcut_count(WeightMode mode) const { return hierarchies[static_cast<int>(mode)].shortcut_count(); }
+
+private:
+    const Graph &graph;
+    ContractionHierarchy hierarchies[3];    // 按 TIME/DISTANCE/BALANCED 下标存放
+};
+
+#endif // CH_H
@@ -0,0 +1,370 @@
+#include "CRP.h"
+#include <limits>
+#include <queue>
+#include <algorithm>
+
+namespace
+{
+    const WeightMode ALL_MODES[3] = {WeightMode::TIME, WeightMode::DISTANCE, WeightMode::BALANCED};
+
+    using QElement = std::pair<double, uint32_t>;
+    using MinQueue = std::priority_queue<QElement, std::vector<QElement>, std::greater<QElement>>;
+}
+
+CRPEngine::CRPEngine() : graph(nullptr)
+{
+}
+
+// 判断graph与已预处理的拓扑是否一致
+bool CRPEngine::matches_topology(const Graph &other) const
+{
+    if (cells.empty() || other.node_count() != node_names.size() ||
+        other.get_offsets() != topology_offsets || other.get_edge_targets() != topology_targets)
+    {
+        return false;
+    }
+
+    for (uint32_t v = 0; v < node_names.size(); ++v)
+    {
+        if (other.get_node_name(v) != node_names[v])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// 与权重无关的预处理
+// 没有坐标信息，使用BFS区域生长划分单元：从未分配的节点出发，沿无向邻接关系扩展到cell_size个节点为止
+void CRPEngine::preprocess(const Graph &source_graph, size_t cell_size)
+{
+    const size_t n = source_graph.node_count();
+    const std::vector<uint32_t> &offsets = source_graph.get_offsets();
+    const std::vector<uint32_t> &targets = source_graph.get_edge_targets();
+    const std::vector<uint32_t> &sources = source_graph.get_edge_sources();
+    const std::vector<uint32_t> &reverse_offsets = source_graph.get_reverse_offsets();
+    const std::vector<uint32_t> &reverse_edges = source_graph.get_reverse_edges();
+
+    graph = nullptr;
+    node_names.resize(n);
+    for (uint32_t v = 0; v < n; ++v)
+    {
+        node_names[v] = source_graph.get_node_name(v);
+    }
+    topology_offsets = offsets;
+    topology_targets = targets;
+
+    cell_size = std::max<size_t>(cell_size, 1);
+    cell_of.assign(n, Graph::INVALID_ID);
+    cells.clear();
+
+    // 无向邻居：出边的终点和入边的起点
+    auto for_each_neighbor = [&](uint32_t u, auto &&visit) {
+        for (uint32_t e = offsets[u]; e < offsets[u + 1]; ++e)
+        {
+            visit(targets[e]);
+        }
+        for (uint32_t i = reverse_offsets[u]; i < reverse_offsets[u + 1]; ++i)
+        {
+            visit(sources[reverse_edges[i]]);
+        }
+    };
+
+    std::queue<uint32_t> frontier;
+    for (uint32_t seed = 0; seed < n; ++seed)
+    {
+        if (cell_of[seed] != Graph::INVALID_ID)
+        {
+            continue;
+        }
+
+        uint32_t cell = static_cast<uint32_t>(cells.size());
+        cells.emplace_back();
+        size_t members = 0;
+
+        frontier = std::queue<uint32_t>();
+        frontier.push(seed);
+        cell_of[seed] = cell;
+
+        while (!frontier.empty())
+        {
+            uint32_t u = frontier.front();
+            frontier.pop();
+            members++;
+
+            for_each_neighbor(u, [&](uint32_t v) {
+                if (cell_of[v] == Graph::INVALID_ID && members + frontier.size() < cell_size)
+                {
+                    cell_of[v] = cell;
+                    frontier.push(v);
+                }
+            });
+        }
+    }
+
+    // 找出每个单元的入口和出口节点
+    entry_index.assign(n, Graph::INVALID_ID);
+    std::vector<bool> is_exit(n, false);
+    for (uint32_t e = 0; e < targets.size(); ++e)
+    {
+        uint32_t u = sources[e];
+        uint32_t v = targets[e];
+        if (cell_of[u] != cell_of[v])
+        {
+            is_exit[u] = true;
+            if (entry_index[v] == Graph::INVALID_ID)
+            {
+                Cell &target_cell = cells[cell_of[v]];
+                entry_index[v] = static_cast<uint32_t>(target_cell.entries.size());
+                target_cell.entries.push_back(v);
+            }
+        }
+    }
+    for (uint32_t v = 0; v < n; ++v)
+    {
+        if (is_exit[v])
+        {
+            cells[cell_of[v]].exits.push_back(v);
+        }
+    }
+
+    // 分配覆盖图权重矩阵
+    size_t overlay_size = 0;
+    for (Cell &cell : cells)
+    {
+        cell.overlay_offset = overlay_size;
+        overlay_size += cell.entries.size() * cell.exits.size();
+    }
+    for (int m = 0; m < 3; ++m)
+    {
+        overlay[m].assign(overlay_size, std::numeric_limits<double>::infinity());
+    }
+}
+
+// 边界节点总数
+size_t CRPEngine::boundary_node_count() const
+{
+    size_t total = 0;
+    for (const Cell &cell : cells)
+    {
+        total += cell.entries.size() + cell.exits.size();
+    }
+    return total;
+}
+
+// 定制阶段：对每种权重模式、每个单元的每个入口做一次单元内Dijkstra
+void CRPEngine::customize(const Graph &snapshot)
+{
+    graph = &snapshot;
+    const size_t n = snapshot.node_count();
+    const double infinity = std::numeric_limits<double>::infinity();
+
+    std::vector<double> distances(n, infinity);
+    std::vector<uint32_t> predecessors(n, Graph::INVALID_ID);
+    std::vector<uint32_t> touched;
+
+    for (int m = 0; m < 3; ++m)
+    {
+        const std::vector<double> &weight = snapshot.weights(ALL_MODES[m]);
+
+        for (const Cell &cell : cells)
+        {
+            for (size_t i = 0; i < cell.entries.size(); ++i)
+            {
+                cell_search(cell.entries[i], weight, distances, predecessors, touched);
+
+                double *row = overlay[m].data() + cell.overlay_offset + i * cell.exits.size();
+                for (size_t j = 0; j < cell.exits.size(); ++j)
+                {
+                    row[j] = distances[cell.exits[j]];
+                }
+
+                for (uint32_t v : touched)
+                {
+                    distances[v] = infinity;
+                    predecessors[v] = Graph::INVALID_ID;
+                }
+                touched.clear();
+            }
+        }
+    }
+}
+
+// 在单元内部做Dijkstra
+void CRPEngine::cell_search(uint32_t source, const std::vector<double> &weight,
+                            std::vector<double> &distances, std::vector<uint32_t> &predecessors,
+                            std::vector<uint32_t> &touched) const
+{
+    const std::vector<uint32_t> &targets = topology_targets;
+    const uint32_t cell = cell_of[source];
+
+    MinQueue pq;
+    distances[source] = 0;
+    touched.push_back(source);
+    pq.push({0.0, source});
+
+    while (!pq.empty())
+    {
+        double current_dist = pq.top().first;
+        uint32_t u = pq.top().second;
+        pq.pop();
+
+        if (current_dist > distances[u])
+        {
+            continue;
+        }
+
+        for (uint32_t e = topology_offsets[u]; e < topology_offsets[u + 1]; ++e)
+        {
+            uint32_t v = targets[e];
+            if (cell_of[v] != cell)
+            {
+                continue;
+            }
+
+            double new_dist = current_dist + weight[e];
+            if (new_dist < distances[v])
+            {
+                if (predecessors[v] == Graph::INVALID_ID && v != source)
+                {
+                    touched.push_back(v);
+                }
+                distances[v] = new_dist;
+                predecessors[v] = e;
+                pq.push({new_dist, v});
+            }
+        }
+    }
+}
+
+// 把覆盖图上的边展开为原图的边（逆序追加）
+void CRPEngine::unpack_overlay_edge(uint32_t entry, uint32_t exit, const std::vector<double> &weight,
+                                    std::vector<uint32_t> &reversed_edges) const
+{
+    const size_t n = node_names.size();
+    std::vector<double> distances(n, std::numeric_limits<double>::infinity());
+    std::vector<uint32_t> predecessors(n, Graph::INVALID_ID);
+    std::vector<uint32_t> touched;
+
+    cell_search(entry, weight, distances, predecessors, touched);
+
+    const std::vector<uint32_t> &sources = graph->get_edge_sources();
+    for (uint32_t v = exit; v != entry; v = sources[predecessors[v]])
+    {
+        reversed_edges.push_back(predecessors[v]);
+    }
+}
+
+// 查询最短路径
+// 起点和终点所在单元内松弛原图的所有出边；其他单元只会到达边界节点：
+// 在入口节点沿覆盖图的边跳到本单元的出口，在出口节点沿单元之间的边离开
+PathResult CRPEngine::find_shortest_path(uint32_t source, uint32_t target, WeightMode mode) const
+{
+    const size_t n = node_names.size();
+    const double infinity = std::numeric_limits<double>::infinity();
+    const int m = static_cast<int>(mode);
+    const std::vector<double> &weight = graph->weights(mode);
+    const uint32_t source_cell = cell_of[source];
+    const uint32_t target_cell = cell_of[target];
+
+    std::vector<double> distances(n, infinity);
+    std::vector<uint32_t> predecessor_edges(n, Graph::INVALID_ID);   // 经原图的边到达
+    std::vector<uint32_t> predecessor_entries(n, Graph::INVALID_ID); // 经覆盖图的边到达（记录入口节点）
+
+    MinQueue pq;
+    distances[source] = 0;
+    pq.push({0.0, source});
+    size_t settled = 0;
+
+    auto relax = [&](uint32_t v, double new_dist, uint32_t edge, uint32_t entry) {
+        if (new_dist < distances[v])
+        {
+            distances[v] = new_dist;
+            predecessor_edges[v] = edge;
+            predecessor_entries[v] = entry;
+            pq.push({new_dist, v});
+        }
+    };
+
+    while (!pq.empty())
+    {
+        double current_dist = pq.top().first;
+        uint32_t u = pq.top().second;
+        pq.pop();
+
+        if (current_dist > distances[u])
+        {
+            continue;
+        }
+        settled++;
+
+        if (u == target)
+        {
+            break;
+        }
+
+        uint32_t cell = cell_of[u];
+        bool local = (cell == source_cell || cell == target_cell);
+
+        // 入口节点：经覆盖图直接到达本单元的各个出口
+        if (!local && entry_index[u] != Graph::INVALID_ID)
+        {
+            const Cell &c = cells[cell];
+            const double *row = overlay[m].data() + c.overlay_offset + entry_index[u] * c.exits.size();
+            for (size_t j = 0; j < c.exits.size(); ++j)
+            {
+                if (c.exits[j] != u)
+                {
+                    relax(c.exits[j], current_dist + row[j], Graph::INVALID_ID, u);
+                }
+            }
+        }
+
+        // 原图的边：本地单元内全部松弛，其他单元只走离开单元的边
+        for (uint32_t e = topology_offsets[u]; e < topology_offsets[u + 1]; ++e)
+        {
+            uint32_t v = topology_targets[e];
+            if (local || cell_of[v] != cell)
+            {
+                relax(v, current_dist + weight[e], e, Graph::INVALID_ID);
+            }
+        }
+    }
+
+    PathResult result;
+    if (distances[target] == infinity)
+    {
+        result.settled_nodes = settled;
+        return result;
+    }
+
+    // 回溯路径，覆盖图的边在单元内重新搜索展开
+    const std::vector<uint32_t> &sources = graph->get_edge_sources();
+    std::vector<uint32_t> edge_path;
+    for (uint32_t v = target; v != source;)
+    {
+        if (predecessor_edges[v] != Graph::INVALID_ID)
+        {
+            edge_path.push_back(predecessor_edges[v]);
+            v = sources[predecessor_edges[v]];
+        }
+        else
+        {
+            unpack_overlay_edge(predecessor_entries[v], v, weight, edge_path);
+            v = predecessor_entries[v];
+        }
+    }
+    std::reverse(edge_path.begin(), edge_path.end());
+
+    result = graph->build_path_result(source, edge_path);
+    result.settled_nodes = settled;
+    return result;
+}
+
+// 并行计算三种模式的最短路径
+MultiPath CRPEngine::find_multi_path(const std::string &start, const std::string &end) const
+{
+    return graph->find_multi_path(start, end, [this](uint32_t source, uint32_t target, WeightMode mode) {
+        return find_shortest_path(source, target, mode);
+    });
+}
@@ -0,0 +1,76 @@
+#ifndef CRP_H
+#define CRP_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Graph.h"
+#include "config.h"
+
+// 可定制路径规划（Customizable Route Planning）
+// 同一测试用例的各个 map_XXXX.csv 拓扑相同，只有现有车辆数（进而time和balanced_score）不同。
+// CRP把工作分成两个阶段：
+//   预处理（与权重无关，每种拓扑只做一次）：把节点划分为小单元（cell），找出单元的边界节点
+//   定制（每个快照做一次，很快）：在每个单元内部计算入口节点到出口节点的最短距离，作为覆盖图（overlay）的边权
+// 查询时，起点和终点所在的单元使用原图的边，其他单元只经过覆盖图的边和单元之间的边
+class CRPEngine
+{
+public:
+    CRPEngine();
+
+    // 判断graph与已预处理的拓扑（节点名、边的起点和终点）是否一致
+    bool matches_topology(const Graph &graph) const;
+
+    // 与权重无关的预处理：划分单元并找出边界节点
+    // cell_size: 每个单元最多包含的节点数
+    void preprocess(const Graph &graph, size_t cell_size);
+
+    // 定制阶段：用graph当前的三种权重重新计算覆盖图的边权
+    // graph必须与预处理时的拓扑一致，并且在下一次定制之前保持有效
+    void customize(const Graph &graph);
+
+    // 查询最短路径（可以被多个线程同时调用）
+    PathResult find_shortest_path(uint32_t source, uint32_t target, WeightMode mode) const;
+
+    // 并行计算三种模式的最短路径
+    MultiPath find_multi_path(const std::string &start, const std::string &end) const;
+
+    // 统计信息
+    size_t cell_count() const { return cells.size(); }
+    size_t boundary_node_count() const;
+
+private:
+    // 单元：入口节点（有来自其他单元的入边）和出口节点（有通往其他单元的出边）
+    struct Cell
+    {
+        std::vector<uint32_t> entries;
+        std::vector<uint32_t> exits;
+        size_t overlay_offset;      // 该单元的 entries × exits 距离矩阵在覆盖图权重数组中的起始位置
+    };
+
+    const Graph *graph;             // 最近一次定制所用的快照
+
+    // 预处理时的拓扑，用于判断新快照能否复用预处理结果
+    std::vector<std::string> node_names;
+    std::vector<uint32_t> topology_offsets;
+    std::vector<uint32_t> topology_targets;
+
+    std::vector<uint32_t> cell_of;          // 节点 -> 所在单元
+    std::vector<uint32_t> entry_index;      // 节点 -> 在所在单元entries中的下标（不是入口为INVALID_ID）
+    std::vector<Cell> cells;
+
+    // 覆盖图权重，按权重模式下标（TIME/DISTANCE/BALANCED）存放，不可达为无穷大
+    std::vector<double> overlay[3];
+
+    // 在单元内部做Dijkstra（只经过同一单元的节点）
+    // distances和predecessors需预先填充为无穷大/INVALID_ID，touched记录被修改过的节点，便于调用方重置
+    void cell_search(uint32_t source, const std::vector<double> &weight,
+                     std::vector<double> &distances, std::vector<uint32_t> &predecessors,
+                     std::vector<uint32_t> &touched) const;
+
+    // 把覆盖图上的一条边（同一单元内的entry -> exit）展开为原图的边，逆序追加到reversed_edges
+    void unpack_overlay_edge(uint32_t entry, uint32_t exit, const std::vector<double> &weight,
+                             std::vector<uint32_t> &reversed_edges) const;
+};
+
+#endif // CRP_H
@@ -1,9 +1,328 @@
 #include "Cache.h"
+#include "ContentHash.h"
 #include <fstream>
 #include <sstream>
 #include <iostream>
 #include <iomanip>
 #include <functional>
+#include <algorithm>
+#include <unordered_set>
+#include <iterator>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+
+namespace
+{
+    // 缓存条目的文本形式，索引文件的entry行和日志的put记录共用
+    // 格式: key|start|end|csv_path|mtime|size|segment_file|created_time|offset|length|content|compute_cost
+    std::string format_entry(const std::string &key, const CacheEntry &entry)
+    {
+        std::ostringstream oss;
+        oss << key << "|"
+            << entry.start << "|"
+            << entry.end << "|"
+            << entry.csv_signature.path << "|"
+            << entry.csv_signature.mtime.time_since_epoch().count() << "|"
+            << entry.csv_signature.size << "|"
+            << entry.cache_file << "|"
+            << entry.created_at.time_since_epoch().count() << "|"
+            << entry.offset << "|"
+            << entry.length;
+        oss << "|" << entry.csv_signature.content << "|" << entry.compute_cost;
+        return oss.str();
+    }
+
+    // 解析format_entry的结果，字段不足或数值无效时返回false
+    bool parse_entry(const std::string &text, std::string &key, CacheEntry &entry)
+    {
+        std::stringstream ss(text);
+        std::vector<std::string> parts;
+        std::string part;
+        while (std::getline(ss, part, '|'))
+        {
+            parts.push_back(part);
+        }
+
+        if (parts.size() < 7)
+        {
+            return false;
+        }
+
+        key = parts[0];
+        entry.start = parts[1];
+        entry.end = parts[2];
+        entry.csv_signature.path = parts[3];
+
+        try
+        {
+            // 解析mtime
+            long long mtime_count = std::stoll(parts[4]);
+            entry.csv_signature.mtime = std::filesystem::file_time_type(
+                std::filesystem::file_time_type::duration(mtime_count));
+
+            // 解析size
+            entry.csv_signature.size = std::stoull(parts[5]);
+
+            entry.cache_file = parts[6];
+
+            // 解析created_time（如果有）
+            if (parts.size() >= 8)
+            {
+                long long created_time = std::stoll(parts[7]);
+                entry.created_at = std::chrono::system_clock::time_point(
+                    std::chrono::system_clock::duration(created_time));
+            }
+
+            // 解析段文件中的位置（旧版本没有，length为0）
+            if (parts.size() >= 10)
+            {
+                entry.offset = std::stoull(parts[8]);
+                entry.length = std::stoull(parts[9]);
+            }
+
+            // 内容指纹（启用content_keys时非空）和计算代价
+            if (parts.size() >= 11)
+            {
+                entry.csv_signature.content = parts[10];
+            }
+            if (parts.size() >= 12)
+            {
+                entry.compute_cost = std::stod(parts[11]);
+            }
+        }
+        catch (const std::exception &e)
+        {
+            return false;
+        }
+        return true;
+    }
+
+    // 日志记录数达到max(2 × 分片容量, 256)时压缩，压缩的开销分摊到每条记录上是O(1)
+    size_t journal_limit(size_t capacity)
+    {
+        return std::max<size_t>(2 * capacity, 256);
+    }
+
+    // 二进制缓存记录的魔数和版本，格式改变时增加版本号，旧版本的记录按未命中处理
+    const char CACHE_RECORD_MAGIC[4] = {'P', 'C', 'R', 'B'};
+    const uint32_t CACHE_RECORD_VERSION = 1;
+
+    // 二进制缓存记录的头部，之后依次存放：
+    // 节点编号 [path_lengths之和]（TIME、DISTANCE、BALANCED三条路径依次排列）|
+    // 名字表偏移 [name_count + 1] | 拼接在一起的名字字节
+    // 节点编号是名字表中的下标，三条路径共用一张名字表，经过的同一地点只存一次
+    struct CacheRecordHeader
+    {
+        char magic[4];
+        uint32_t version;
+        double times[3];            // 三条路径的time，顺序同上
+        double distances[3];        // 三条路径的distance
+        uint32_t path_lengths[3];   // 三条路径的节点数
+        uint32_t name_count;
+        uint32_t name_bytes;
+    };
+
+    // 把MultiPath编码为一条二进制缓存记录
+    std::string format_record(const MultiPath &paths)
+    {
+        const PathResult *results[3] = {&paths.time_path, &paths.distance_path, &paths.balanced_path};
+
+        CacheRecordHeader header{};
+        std::memcpy(header.magic, CACHE_RECORD_MAGIC, sizeof(header.magic));
+        header.version = CACHE_RECORD_VERSION;
+
+        // 为出现的地点分配编号
+        std::unordered_map<std::string_view, uint32_t> name_ids;
+        std::vector<std::string_view> names;
+        std::vector<uint32_t> node_ids;
+        for (int i = 0; i < 3; ++i)
+        {
+            header.times[i] = results[i]->time;
+            header.distances[i] = results[i]->distance;
+            header.path_lengths[i] = static_cast<uint32_t>(results[i]->path.size());
+            for (const std::string &node : results[i]->path)
+            {
+                auto inserted = name_ids.emplace(node, static_cast<uint32_t>(names.size()));
+                if (inserted.second)
+                {
+                    names.push_back(node);
+                }
+                node_ids.push_back(inserted.first->second);
+            }
+        }
+
+        std::vector<uint32_t> name_offsets(names.size() + 1, 0);
+        for (size_t i = 0; i < names.size(); ++i)
+        {
+            name_offsets[i + 1] = name_offsets[i] + static_cast<uint32_t>(names[i].size());
+        }
+        header.name_count = static_cast<uint32_t>(names.size());
+        header.name_bytes = name_offsets.back();
+
+        std::string record;
+        record.reserve(sizeof(header) + (node_ids.size() + name_offsets.size()) * sizeof(uint32_t) + header.name_bytes);
+        record.append(reinterpret_cast<const char *>(&header), sizeof(header));
+        record.append(reinterpret_cast<const char *>(node_ids.data()), node_ids.size() * sizeof(uint32_t));
+        record.append(reinterpret_cast<const char *>(name_offsets.data()), name_offsets.size() * sizeof(uint32_t));
+        for (std::string_view name : names)
+        {
+            record.append(name);
+        }
+        return record;
+    }
+
+    // 旧版本的文本记录（单独的缓存文件或早期的段文件），依次为三种路径，每种路径以"# 类型"行开始，
+    // 之后是"time: "和"distance: "行以及路径上的地点。旧版本写入时三种路径和它们的time、distance总是齐全的，
+    // 缺少任何一项、标记之前出现其他内容或数值无法解析时视为损坏，返回false
+    bool parse_text_record(std::string_view record, MultiPath &paths)
+    {
+        paths = MultiPath();
+        PathResult *current_result = nullptr;
+        int current_section = -1;
+        bool has_time[3] = {false, false, false};
+        bool has_distance[3] = {false, false, false};
+
+        try
+        {
+            while (!record.empty())
+            {
+                size_t line_end = record.find('\n');
+                std::string_view line = record.substr(0, line_end);
+                record.remove_prefix(line_end == std::string_view::npos ? record.size() : line_end + 1);
+
+                // 移除可能的回车符
+                if (!line.empty() && line.back() == '\r')
+                {
+                    line.remove_suffix(1);
+                }
+
+                if (line.empty())
+                {
+                    continue;  // 跳过空行
+                }
+
+                // 检查是否是路径类型标记
+                if (line == "# TIME")
+                {
+                    current_result = &paths.time_path;
+                    current_section = 0;
+                }
+                else if (line == "# DISTANCE")
+                {
+                    current_result = &paths.distance_path;
+                    current_section = 1;
+                }
+                else if (line == "# BALANCED")
+                {
+                    current_result = &paths.balanced_path;
+                    current_section = 2;
+                }
+                else if (current_result == nullptr)
+                {
+                    return false;  // 第一个标记之前不应有其他内容
+                }
+                else if (line.rfind("cost: ", 0) == 0)
+                {
+                    // 已废弃，为了兼容性保留
+                }
+                else if (line.rfind("time: ", 0) == 0)
+                {
+                    current_result->time = std::stod(std::string(line.substr(6)));
+                    has_time[current_section] = true;
+                }
+                else if (line.rfind("distance: ", 0) == 0)
+                {
+                    current_result->distance = std::stod(std::string(line.substr(10)));
+                    has_distance[current_section] = true;
+                }
+                else
+                {
+                    // 添加节点到当前路径
+                    current_result->path.emplace_back(line);
+                }
+            }
+        }
+        catch (const std::exception &)
+        {
+            return false;  // std::stod无法解析或超出范围
+        }
+
+        for (int i = 0; i < 3; ++i)
+        {
+            if (!has_time[i] || !has_distance[i])
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // 解析一条缓存记录：二进制记录直接按头部给出的长度取出各部分，不以魔数开头的按旧版本文本记录解析
+    // 版本不符、长度不一致、节点编号越界或文本记录不完整时返回false
+    bool parse_record(std::string_view record, MultiPath &paths)
+    {
+        if (record.size() < sizeof(CACHE_RECORD_MAGIC) ||
+            std::memcmp(record.data(), CACHE_RECORD_MAGIC, sizeof(CACHE_RECORD_MAGIC)) != 0)
+        {
+            return parse_text_record(record, paths);
+        }
+
+        CacheRecordHeader header;
+        if (record.size() < sizeof(header))
+        {
+            return false;
+        }
+        std::memcpy(&header, record.data(), sizeof(header));
+        record.remove_prefix(sizeof(header));
+
+        size_t node_count = static_cast<size_t>(header.path_lengths[0]) + header.path_lengths[1] + header.path_lengths[2];
+        size_t table_size = (node_count + header.name_count + 1) * sizeof(uint32_t);
+        if (header.version != CACHE_RECORD_VERSION || record.size() != table_size + header.name_bytes)
+        {
+            return false;
+        }
+
+        // 记录在段文件中的偏移不一定对齐，数组先复制出来
+        std::vector<uint32_t> table(node_count + header.name_count + 1);
+        std::memcpy(table.data(), record.data(), table_size);
+        const uint32_t *node_ids = table.data();
+        const uint32_t *name_offsets = table.data() + node_count;
+        std::string_view name_bytes = record.substr(table_size);
+        if (name_offsets[header.name_count] != header.name_bytes)
+        {
+            return false;
+        }
+
+        std::vector<std::string_view> names(header.name_count);
+        for (size_t i = 0; i < names.size(); ++i)
+        {
+            if (name_offsets[i + 1] < name_offsets[i])
+            {
+                return false;
+            }
+            names[i] = name_bytes.substr(name_offsets[i], name_offsets[i + 1] - name_offsets[i]);
+        }
+
+        PathResult *results[3] = {&paths.time_path, &paths.distance_path, &paths.balanced_path};
+        for (int i = 0; i < 3; ++i)
+        {
+            results[i]->time = header.times[i];
+            results[i]->distance = header.distances[i];
+            results[i]->path.clear();
+            results[i]->path.reserve(header.path_lengths[i]);
+            for (uint32_t j = 0; j < header.path_lengths[i]; ++j, ++node_ids)
+            {
+                if (*node_ids >= names.size())
+                {
+                    return false;
+                }
+                results[i]->path.emplace_back(names[*node_ids]);
+            }
+        }
+        return true;
+    }
+}
 
 FileSignature::FileSignature(const std::string &file_path)
 {
@@ -16,6 +335,10 @@ FileSignature::FileSignature(const std::string &file_path)
             path = std::filesystem::canonical(file_path).string();
             mtime = std::filesystem::last_write_time(file_path);
             size = std::filesystem::file_size(file_path);
+            if (CacheConfig::content_keys)
+            {
+                content = content_fingerprint(file_path);
+            }
         }
         else
         {
@@ -34,6 +357,12 @@ FileSignature::FileSignature(const std::string &file_path)
 
 bool FileSignature::matches(const std::string &file_path) const
 {
+    // 内容指纹按文件身份记忆，未变化的文件不会重新读取
+    if (!content.empty())
+    {
+        return content_fingerprint(file_path) == content;
+    }
+
     try
     {
         if (!std::filesystem::exists(file_path))
@@ -56,15 +385,56 @@ std::string FileSignature::to_string() const
 {
     // 将文件签名转换为字符串，用于生成缓存键
     std::ostringstream oss;
-    oss << path << "|" << mtime.time_since_epoch().count() << "|" << size;
+    if (!content.empty())
+    {
+        oss << "xxh64:" << content << "|" << size;
+    }
+    else
+    {
+        oss << path << "|" << mtime.time_since_epoch().count() << "|" << size;
+    }
+    return oss.str();
+}
+
+std::string FileSignature::to_key() const
+{
+    std::hash<std::string> hasher;
+    size_t hash_value = hasher(to_string());
+
+    std::ostringstream oss;
+    oss << std::hex << std::setfill('0') << std::setw(16) << hash_value;
     return oss.str();
 }
 
-PathCache::PathCache(const std::string &cache_dir, size_t max_size)
-    : cache_dir(cache_dir), max_size(max_size), hit_count(0), miss_count(0)
+std::string FileSignature::path_key() const
 {
-    paths_dir = cache_dir + "/paths";
-    index_file_path = cache_dir + "/cache_index.txt";
+    std::hash<std::string> hasher;
+    size_t hash_value = hasher(path);
+
+    std::ostringstream oss;
+    oss << std::hex << std::setfill('0') << std::setw(16) << hash_value;
+    return oss.str();
+}
+
+PathCache::PathCache(const std::string &cache_dir, size_t max_size, size_t shard_count, CachePolicy policy)
+    : cache_dir(cache_dir), max_size(max_size), policy(policy),
+      shards(std::max<size_t>(1, std::min(shard_count, max_size))), hit_count(0), miss_count(0),
+      rejected_count(0), bytes_saved(0), compute_saved_us(0), compactor(1)
+{
+    segments_dir = cache_dir + "/segments";
+
+    // 容量平均分给各分片，余数分给前面的分片
+    for (size_t i = 0; i < shards.size(); ++i)
+    {
+        shards[i].capacity = max_size / shards.size() + (i < max_size % shards.size() ? 1 : 0);
+        shards[i].index_file_path = cache_dir + "/cache_index_" + std::to_string(i) + ".txt";
+        shards[i].journal_file_path = cache_dir + "/cache_index_" + std::to_string(i) + ".journal";
+        shards[i].segment_prefix = segments_dir + "/shard_" + std::to_string(i) + "_";
+        if (policy == CachePolicy::TINY_LFU)
+        {
+            shards[i].sketch = FrequencySketch(4 * shards[i].capacity);
+        }
+    }
 
     init_cache_dir();
     load_index();
@@ -78,9 +448,9 @@ void PathCache::init_cache_dir()
         {
             std::filesystem::create_directories(cache_dir);
         }
-        if (!std::filesystem::exists(paths_dir))
+        if (!std::filesystem::exists(segments_dir))
         {
-            std::filesystem::create_directories(paths_dir);
+            std::filesystem::create_directories(segments_dir);
         }
     }
     catch (const std::filesystem::filesystem_error &e)
@@ -106,19 +476,38 @@ std::string PathCache::generate_key(const std::string &start,
     return oss.str();
 }
 
+PathCache::Shard &PathCache::shard_for(const std::string &key)
+{
+    return shards[std::hash<std::string>()(key) % shards.size()];
+}
+
 MultiPath PathCache::get(const std::string &start,
                           const std::string &end,
-                          const std::string &csv_file)
+                          const std::string &csv_file,
+                          bool *hit)
 {
     MultiPath empty_result;  // 空结果
+    if (hit != nullptr)
+    {
+        *hit = false;
+    }
 
     // 生成文件签名
     FileSignature sig(csv_file);
     std::string key = generate_key(start, end, sig);
 
+    Shard &shard = shard_for(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    // TinyLFU统计每次查询（命中和未命中都算）的频率
+    if (policy == CachePolicy::TINY_LFU)
+    {
+        shard.sketch.increment(std::hash<std::string>()(key));
+    }
+
     // 查找缓存条目
-    auto it = entries.find(key);
-    if (it == entries.end())
+    auto it = shard.entries.find(key);
+    if (it == shard.entries.end())
     {
         // 缓存未命中
         miss_count++;
@@ -129,237 +518,691 @@ MultiPath PathCache::get(const std::string &start,
     if (!it->second.csv_signature.matches(csv_file))
     {
         // 文件已修改，删除过期缓存
-        std::filesystem::remove(it->second.cache_file);
-        lru_list.remove(key);
-        entries.erase(it);
+        unlink(shard, it);
+        append_journal(shard, "evict: " + key);
+        schedule_compaction(shard);
+        miss_count++;
+        return empty_result;
+    }
+
+    // 从段文件读取记录，记录损坏时按未命中处理
+    MultiPath paths;
+    if (!read_record(shard, it->second, paths))
+    {
+        unlink(shard, it);
+        append_journal(shard, "evict: " + key);
         miss_count++;
         return empty_result;
     }
 
     // 缓存命中，更新LRU顺序
-    touch(key);
+    touch(shard, it->second);
     hit_count++;
-
-    // 读取缓存文件
-    return read_cache_file(it->second.cache_file);
+    bytes_saved += it->second.length;
+    compute_saved_us += static_cast<uint64_t>(it->second.compute_cost * 1000.0);
+    if (hit != nullptr)
+    {
+        *hit = true;
+    }
+    return paths;
 }
 
 void PathCache::put(const std::string &start,
                     const std::string &end,
                     const std::string &csv_file,
-                    const MultiPath &paths)
+                    const MultiPath &paths,
+                    double compute_cost)
 {
     // 生成文件签名和键
     FileSignature sig(csv_file);
     std::string key = generate_key(start, end, sig);
 
-    // 如果已存在，先删除旧的
-    auto it = entries.find(key);
-    if (it != entries.end())
+    Shard &shard = shard_for(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    // 如果已存在，先删除旧的（新的put记录会覆盖它，不需要单独记录）
+    auto it = shard.entries.find(key);
+    if (it != shard.entries.end())
     {
-        std::filesystem::remove(it->second.cache_file);
-        lru_list.remove(key);
-        entries.erase(it);
+        unlink(shard, it);
     }
 
-    // 检查是否需要淘汰
-    if (entries.size() >= max_size)
+    // LRU：放入前淘汰最久未使用的条目；TinyLFU：新条目先进入窗口区，离开窗口时再决定是否接纳
+    if (policy == CachePolicy::LRU && shard.entries.size() >= shard.capacity)
     {
-        evict_lru();
+        evict_victim(shard);
     }
 
-    // 创建缓存文件
-    std::string cache_file = paths_dir + "/" + key + ".cache";
-    write_cache_file(cache_file, paths);
-
-    // 创建缓存条目
+    // 创建缓存条目，记录追加到段文件
     CacheEntry entry;
     entry.start = start;
     entry.end = end;
     entry.csv_signature = sig;
-    entry.cache_file = cache_file;
     entry.created_at = std::chrono::system_clock::now();
+    entry.compute_cost = compute_cost;
+    entry.in_window = policy == CachePolicy::TINY_LFU;
+    if (append_record(shard, format_record(paths), entry))
+    {
+        // 添加到缓存并记录日志
+        link(shard, key, entry);
+        append_journal(shard, "put: " + format_entry(key, entry));
+    }
+    if (policy == CachePolicy::TINY_LFU)
+    {
+        admit_from_window(shard);
+    }
+    schedule_compaction(shard);
+}
 
-    // 添加到缓存
-    entries[key] = entry;
-    lru_list.push_front(key);
+void PathCache::clear()
+{
+    for (Shard &shard : shards)
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+
+        // 清空数据结构
+        shard.entries.clear();
+        shard.lru_list.clear();
+        shard.window_list.clear();
+        shard.sketch.clear();
+
+        // 段文件清空后继续使用
+        shard.mapped.close();
+        shard.segment.close();
+        shard.segment.open(shard.segment_path, std::ios::binary | std::ios::trunc);
+        shard.segment_size = 0;
+        shard.live_bytes = 0;
+
+        // 删除索引文件，日志清空后继续使用
+        std::filesystem::remove(shard.index_file_path);
+        shard.journal.close();
+        shard.journal.open(shard.journal_file_path, std::ios::trunc);
+        shard.journal_records = 0;
+    }
 
-    // 保存索引
-    save_index();
+    hit_count = 0;
+    miss_count = 0;
+    rejected_count = 0;
+    bytes_saved = 0;
+    compute_saved_us = 0;
 }
 
-void PathCache::clear()
+size_t PathCache::get_entry_count() const
 {
-    // 删除所有缓存文件
-    for (const auto &pair : entries)
+    size_t count = 0;
+    for (const Shard &shard : shards)
     {
-        std::filesystem::remove(pair.second.cache_file);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        count += shard.entries.size();
     }
+    return count;
+}
 
-    // 清空数据结构
-    entries.clear();
-    lru_list.clear();
+void PathCache::link(Shard &shard, const std::string &key, const CacheEntry &entry)
+{
+    shard.lru_list.push_front(key);
+    CacheEntry &linked = shard.entries[key];
+    linked = entry;
+    linked.lru_position = shard.lru_list.begin();
+    if (linked.in_window)
+    {
+        shard.window_list.push_front(key);
+        linked.window_position = shard.window_list.begin();
+    }
+    shard.live_bytes += linked.length;
+}
 
-    // 删除索引文件
-    if (std::filesystem::exists(index_file_path))
+void PathCache::unlink(Shard &shard, std::unordered_map<std::string, CacheEntry>::iterator it)
+{
+    shard.live_bytes -= std::min(shard.live_bytes, it->second.length);
+    if (it->second.in_window)
     {
-        std::filesystem::remove(index_file_path);
+        shard.window_list.erase(it->second.window_position);
     }
+    shard.lru_list.erase(it->second.lru_position);
+    shard.entries.erase(it);
+}
 
-    hit_count = 0;
-    miss_count = 0;
+void PathCache::evict(Shard &shard, std::unordered_map<std::string, CacheEntry>::iterator it)
+{
+    // 删除条目，记录在段文件中失效
+    std::string key = it->first;
+    unlink(shard, it);
+    append_journal(shard, "evict: " + key);
 }
 
-void PathCache::evict_lru()
+void PathCache::evict_victim(Shard &shard)
 {
-    if (lru_list.empty())
+    if (shard.lru_list.empty())
     {
         return;
     }
 
-    // 获取最久未使用的键（列表末尾）
-    std::string oldest_key = lru_list.back();
-    lru_list.pop_back();
-
-    // 删除缓存文件和条目
-    auto it = entries.find(oldest_key);
-    if (it != entries.end())
+    auto victim = shard.entries.end();
+    if (policy == CachePolicy::TINY_LFU)
+    {
+        victim = select_victim(shard, nullptr);
+    }
+    if (victim == shard.entries.end())
     {
-        std::filesystem::remove(it->second.cache_file);
-        entries.erase(it);
+        // 最久未使用的键（列表末尾）
+        victim = shard.entries.find(shard.lru_list.back());
     }
+    evict(shard, victim);
 }
 
-void PathCache::touch(const std::string &key)
+double PathCache::score(Shard &shard, const std::string &key, const CacheEntry &entry)
 {
-    // 从列表中移除（无论在哪个位置）
-    lru_list.remove(key);
-    // 添加到最前面
-    lru_list.push_front(key);
+    // 频率加一，冷启动（sketch为空）时仍按代价和大小区分
+    double frequency = shard.sketch.estimate(std::hash<std::string>()(key)) + 1.0;
+    return frequency * std::max(entry.compute_cost, 0.001) / static_cast<double>(std::max<uint64_t>(entry.length, 1));
 }
 
-MultiPath PathCache::read_cache_file(const std::string &file_path)
+std::unordered_map<std::string, CacheEntry>::iterator PathCache::select_victim(Shard &shard, const std::string *exclude)
 {
-    MultiPath paths;
-    std::ifstream file(file_path);
+    // 从LRU末尾取若干个主区条目，淘汰其中得分最低的
+    const size_t SAMPLE_SIZE = 8;
 
-    if (!file.is_open())
+    auto victim = shard.entries.end();
+    double victim_score = 0;
+    size_t sampled = 0;
+    for (auto position = shard.lru_list.rbegin(); position != shard.lru_list.rend() && sampled < SAMPLE_SIZE; ++position)
     {
-        return paths;
+        auto it = shard.entries.find(*position);
+        if (it->second.in_window || (exclude != nullptr && *exclude == it->first))
+        {
+            continue;
+        }
+        double value = score(shard, it->first, it->second);
+        if (victim == shard.entries.end() || value < victim_score)
+        {
+            victim = it;
+            victim_score = value;
+        }
+        sampled++;
     }
+    return victim;
+}
 
-    std::string line;
-    PathResult *current_result = nullptr;
-    std::string current_section = "";
+void PathCache::admit_from_window(Shard &shard)
+{
+    // 窗口区占分片容量的1%（至少1个），抵御一次性扫描的同时让新条目有机会积累频率
+    size_t window_capacity = std::max<size_t>(1, shard.capacity / 100);
 
-    while (std::getline(file, line))
+    while (shard.window_list.size() > window_capacity)
     {
-        // 移除可能的回车符
-        if (!line.empty() && line.back() == '\r')
+        // 离开窗口的条目进入主区
+        std::string candidate = shard.window_list.back();
+        shard.window_list.pop_back();
+        auto candidate_it = shard.entries.find(candidate);
+        candidate_it->second.in_window = false;
+        if (shard.entries.size() <= shard.capacity)
         {
-            line.pop_back();
+            continue;
         }
 
-        if (line.empty())
+        // 主区已满：与主区的淘汰候选比较，得分更高才接纳，否则淘汰候选者自己
+        auto victim = select_victim(shard, &candidate);
+        if (victim != shard.entries.end() &&
+            score(shard, candidate, candidate_it->second) > score(shard, victim->first, victim->second))
+        {
+            evict(shard, victim);
+        }
+        else
         {
-            continue;  // 跳过空行
+            evict(shard, candidate_it);
+            rejected_count++;
         }
+    }
+
+    while (shard.entries.size() > shard.capacity)
+    {
+        evict_victim(shard);
+    }
+}
+
+void PathCache::touch(Shard &shard, CacheEntry &entry)
+{
+    // 直接按保存的位置把节点移到最前面，不需要查找
+    shard.lru_list.splice(shard.lru_list.begin(), shard.lru_list, entry.lru_position);
+    if (entry.in_window)
+    {
+        shard.window_list.splice(shard.window_list.begin(), shard.window_list, entry.window_position);
+    }
+    append_journal(shard, "touch: " + *entry.lru_position);
+}
 
-        // 检查是否是路径类型标记
-        if (line == "# TIME")
+void PathCache::append_journal(Shard &shard, const std::string &record)
+{
+    if (!shard.journal.is_open())
+    {
+        return;
+    }
+
+    // 每条记录立即写出，进程中途退出时最多丢失正在写的这一行
+    shard.journal << record << "\n" << std::flush;
+    shard.journal_records++;
+    if (shard.journal_records >= journal_limit(shard.capacity))
+    {
+        compact(shard);
+    }
+}
+
+bool PathCache::compact(Shard &shard)
+{
+    // 完整索引保存失败时保留日志，下次加载仍能恢复
+    if (!save_index(shard))
+    {
+        return false;
+    }
+
+    shard.journal.close();
+    shard.journal.open(shard.journal_file_path, std::ios::trunc);
+    shard.journal_records = 0;
+    return true;
+}
+
+bool PathCache::append_record(Shard &shard, const std::string &record, CacheEntry &entry)
+{
+    if (!shard.segment.is_open())
+    {
+        return false;
+    }
+
+    shard.segment.write(record.data(), static_cast<std::streamsize>(record.size()));
+    shard.segment.flush();
+    if (!shard.segment)
+    {
+        // 可能写出了一部分，按文件的实际长度继续追加，写出的部分视为失效记录
+        std::cerr << "Error: Could not write cache segment " << shard.segment_path << std::endl;
+        std::error_code error;
+        shard.segment.clear();
+        shard.segment_size = std::max<uint64_t>(shard.segment_size, std::filesystem::file_size(shard.segment_path, error));
+        return false;
+    }
+
+    entry.cache_file = shard.segment_path;
+    entry.offset = shard.segment_size;
+    entry.length = record.size();
+    shard.segment_size += record.size();
+    return true;
+}
+
+bool PathCache::read_record(Shard &shard, const CacheEntry &entry, MultiPath &paths)
+{
+    // 映射建立之后追加的记录不在映射范围内，重新映射整个段文件
+    if (entry.offset + entry.length > shard.mapped.size() && !shard.mapped.open(shard.segment_path))
+    {
+        return false;
+    }
+    if (entry.length == 0 || entry.offset + entry.length > shard.mapped.size())
+    {
+        return false;
+    }
+
+    return parse_record(shard.mapped.view().substr(entry.offset, entry.length), paths);
+}
+
+void PathCache::schedule_compaction(Shard &shard)
+{
+    uint64_t dead_bytes = shard.segment_size - std::min(shard.segment_size, shard.live_bytes);
+    if (shard.compaction_queued || dead_bytes < CacheConfig::segment_compact_bytes || dead_bytes <= shard.live_bytes)
+    {
+        return;
+    }
+
+    // 压缩在后台线程上持有分片的锁执行，只阻塞同一分片上的查询
+    shard.compaction_queued = true;
+    compactor.submit([this, &shard]()
+                     {
+                         std::lock_guard<std::mutex> lock(shard.mutex);
+                         compact_segment(shard);
+                     });
+}
+
+void PathCache::compact_segment(Shard &shard)
+{
+    shard.compaction_queued = false;
+
+    // 确保映射覆盖所有记录
+    if (shard.mapped.size() < shard.segment_size && !shard.mapped.open(shard.segment_path))
+    {
+        std::cerr << "Error: Could not map cache segment " << shard.segment_path << std::endl;
+        return;
+    }
+
+    std::string old_path = shard.segment_path;
+    std::string new_path = shard.segment_prefix + std::to_string(shard.generation + 1) + ".seg";
+    std::ofstream out(new_path, std::ios::binary | std::ios::trunc);
+    if (!out.is_open())
+    {
+        std::cerr << "Error: Could not create cache segment " << new_path << std::endl;
+        return;
+    }
+
+    // 按LRU顺序复制有效记录，最近使用的记录在文件中相邻
+    std::vector<uint64_t> offsets;
+    offsets.reserve(shard.lru_list.size());
+    uint64_t size = 0;
+    for (const std::string &key : shard.lru_list)
+    {
+        const CacheEntry &entry = shard.entries.at(key);
+        out.write(shard.mapped.data() + entry.offset, static_cast<std::streamsize>(entry.length));
+        offsets.push_back(size);
+        size += entry.length;
+    }
+    out.close();
+    if (!out)
+    {
+        std::cerr << "Error: Could not write cache segment " << new_path << std::endl;
+        std::filesystem::remove(new_path);
+        return;
+    }
+
+    size_t i = 0;
+    for (const std::string &key : shard.lru_list)
+    {
+        CacheEntry &entry = shard.entries.at(key);
+        entry.cache_file = new_path;
+        entry.offset = offsets[i++];
+    }
+
+    shard.mapped.close();
+    shard.segment.close();
+    shard.generation++;
+    shard.segment_path = new_path;
+    shard.segment_size = size;
+    shard.live_bytes = size;
+    shard.segment.open(new_path, std::ios::binary | std::ios::app);
+
+    // 索引指向新段文件之后才能删除旧文件；索引保存失败时保留旧文件，日志中的put记录仍然有效
+    if (compact(shard))
+    {
+        std::filesystem::remove(old_path);
+    }
+}
+
+bool PathCache::attach_segment(Shard &shard, std::unordered_map<std::string, std::unique_ptr<MappedFile>> &sources)
+{
+    // 沿用条目引用最多的本分片段文件，代号取自文件名
+    std::unordered_map<std::string, size_t> references;
+    for (const auto &pair : shard.entries)
+    {
+        if (pair.second.length > 0 && pair.second.cache_file.rfind(shard.segment_prefix, 0) == 0)
         {
-            current_result = &paths.time_path;
-            current_section = "TIME";
+            references[pair.second.cache_file]++;
         }
-        else if (line == "# DISTANCE")
+    }
+    std::string reused;
+    size_t most = 0;
+    for (const auto &pair : references)
+    {
+        if (pair.second > most && std::filesystem::exists(pair.first))
         {
-            current_result = &paths.distance_path;
-            current_section = "DISTANCE";
+            reused = pair.first;
+            most = pair.second;
         }
-        else if (line == "# BALANCED")
+    }
+
+    if (!reused.empty())
+    {
+        shard.segment_path = reused;
+        shard.generation = std::stoull(reused.substr(shard.segment_prefix.size()));
+    }
+    else
+    {
+        // 新建的段文件不能与目录中已有的同名：代号取已有段文件的最大代号加一
+        shard.generation = 0;
+        std::error_code error;
+        for (const auto &item : std::filesystem::directory_iterator(segments_dir, error))
         {
-            current_result = &paths.balanced_path;
-            current_section = "BALANCED";
+            std::string path = item.path().string();
+            if (path.rfind(shard.segment_prefix, 0) == 0)
+            {
+                shard.generation = std::max<uint64_t>(shard.generation, std::strtoull(path.c_str() + shard.segment_prefix.size(), nullptr, 10) + 1);
+            }
         }
-        else if (line.rfind("cost: ", 0) == 0)
+        shard.segment_path = shard.segment_prefix + std::to_string(shard.generation) + ".seg";
+    }
+
+    std::error_code error;
+    shard.segment.open(shard.segment_path, std::ios::binary | std::ios::app);
+    shard.segment_size = std::filesystem::file_size(shard.segment_path, error);
+    if (!shard.segment.is_open() || error)
+    {
+        std::cerr << "Warning: Could not open cache segment " << shard.segment_path << std::endl;
+        shard.segment.close();
+        shard.segment_size = 0;
+    }
+
+    bool changed = false;
+    std::vector<std::string> dropped;
+    for (auto &pair : shard.entries)
+    {
+        CacheEntry &entry = pair.second;
+        if (entry.length > 0 && entry.cache_file == shard.segment_path)
         {
-            // 已废弃，为了兼容性保留
+            // 段文件末尾的记录可能在写入时进程退出而不完整
+            if (entry.offset + entry.length > shard.segment_size)
+            {
+                dropped.push_back(pair.first);
+            }
+            continue;
         }
-        else if (line.rfind("time: ", 0) == 0)
+
+        // 不在当前段文件中的记录复制过来
+        std::string record;
+        if (entry.length == 0)
         {
-            // 解析time值
-            if (current_result != nullptr)
+            // 旧版本的单独缓存文件
+            std::ifstream file(entry.cache_file, std::ios::binary);
+            record.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+            if (!file.is_open() || record.empty())
             {
-                current_result->time = std::stod(line.substr(6));
+                dropped.push_back(pair.first);
+                continue;
             }
         }
-        else if (line.rfind("distance: ", 0) == 0)
+        else
         {
-            // 解析distance值
-            if (current_result != nullptr)
+            auto &source = sources[entry.cache_file];
+            if (source == nullptr)
+            {
+                source = std::make_unique<MappedFile>();
+                source->open(entry.cache_file);
+            }
+            if (entry.offset + entry.length > source->size())
             {
-                current_result->distance = std::stod(line.substr(10));
+                dropped.push_back(pair.first);
+                continue;
             }
+            record.assign(source->data() + entry.offset, entry.length);
         }
-        else if (current_result != nullptr)
+
+        if (!append_record(shard, record, entry))
         {
-            // 添加节点到当前路径
-            current_result->path.push_back(line);
+            dropped.push_back(pair.first);
         }
+        changed = true;
     }
 
-    file.close();
-    return paths;
+    for (const std::string &key : dropped)
+    {
+        unlink(shard, shard.entries.find(key));
+    }
+
+    shard.live_bytes = 0;
+    for (const auto &pair : shard.entries)
+    {
+        shard.live_bytes += pair.second.length;
+    }
+    return changed || !dropped.empty();
 }
 
-void PathCache::write_cache_file(const std::string &file_path, const MultiPath &paths)
+void PathCache::load_index()
 {
-    std::ofstream file(file_path);
-
-    if (!file.is_open())
+    // 收集所有索引文件和日志：cache_index.txt（未分片的旧版本）、cache_index_<分片号>.txt 和 cache_index_<分片号>.journal
+    std::vector<std::string> index_files;
+    std::vector<std::string> journal_files;
+    try
+    {
+        for (const auto &item : std::filesystem::directory_iterator(cache_dir))
+        {
+            std::string name = item.path().filename().string();
+            if (!item.is_regular_file() || name.rfind("cache_index", 0) != 0)
+            {
+                continue;
+            }
+            if (item.path().extension() == ".txt")
+            {
+                index_files.push_back(item.path().string());
+            }
+            else if (item.path().extension() == ".journal")
+            {
+                journal_files.push_back(item.path().string());
+            }
+        }
+    }
+    catch (const std::filesystem::filesystem_error &e)
     {
-        std::cerr << "Error: Could not create cache file " << file_path << std::endl;
+        std::cerr << "Warning: Could not read cache directory: " << e.what() << std::endl;
         return;
     }
+    std::sort(index_files.begin(), index_files.end());
+    std::sort(journal_files.begin(), journal_files.end());
 
-    // 写入时间最短路径
-    file << "# TIME\n";
-    file << "time: " << paths.time_path.time << "\n";
-    file << "distance: " << paths.time_path.distance << "\n";
-    for (const auto &node : paths.time_path.path)
+    for (const std::string &file_path : index_files)
     {
-        file << node << "\n";
+        load_index_file(file_path);
     }
 
-    // 写入距离最短路径
-    file << "# DISTANCE\n";
-    file << "time: " << paths.distance_path.time << "\n";
-    file << "distance: " << paths.distance_path.distance << "\n";
-    for (const auto &node : paths.distance_path.path)
+    for (Shard &shard : shards)
     {
-        file << node << "\n";
+        // 清理LRU列表中不存在的条目，以及合并多个索引文件时重复的键，并记下每个条目的位置
+        std::unordered_set<std::string> listed;
+        auto it = shard.lru_list.begin();
+        while (it != shard.lru_list.end())
+        {
+            auto entry = shard.entries.find(*it);
+            if (entry == shard.entries.end() || !listed.insert(*it).second)
+            {
+                it = shard.lru_list.erase(it);
+            }
+            else
+            {
+                entry->second.lru_position = it;
+                ++it;
+            }
+        }
+
+        // 不在LRU列表中的条目视为最久未使用
+        for (auto &pair : shard.entries)
+        {
+            if (listed.find(pair.first) == listed.end())
+            {
+                pair.second.lru_position = shard.lru_list.insert(shard.lru_list.end(), pair.first);
+            }
+        }
     }
 
-    // 写入综合推荐路径
-    file << "# BALANCED\n";
-    file << "time: " << paths.balanced_path.time << "\n";
-    file << "distance: " << paths.balanced_path.distance << "\n";
-    for (const auto &node : paths.balanced_path.path)
+    // 在完整索引的基础上按顺序重放日志
+    size_t replayed = 0;
+    for (const std::string &file_path : journal_files)
     {
-        file << node << "\n";
+        replayed += replay_journal(file_path);
     }
 
-    file.close();
-}
+    // 为每个分片选定段文件，其他文件中的记录复制过来
+    bool migrated = false;
+    {
+        std::unordered_map<std::string, std::unique_ptr<MappedFile>> sources;
+        for (Shard &shard : shards)
+        {
+            migrated = attach_segment(shard, sources) || migrated;
+        }
+    }
 
-void PathCache::load_index()
-{
-    if (!std::filesystem::exists(index_file_path))
+    // 不属于当前各分片的文件（分片数改变或旧版索引）在条目重新分配并压缩后删除
+    std::vector<std::string> stale_files;
+    for (const std::vector<std::string> *files : {&index_files, &journal_files})
     {
-        return;
+        for (const std::string &file_path : *files)
+        {
+            bool current = false;
+            for (const Shard &shard : shards)
+            {
+                current = current || std::filesystem::path(file_path) == std::filesystem::path(shard.index_file_path) ||
+                          std::filesystem::path(file_path) == std::filesystem::path(shard.journal_file_path);
+            }
+            if (!current)
+            {
+                stale_files.push_back(file_path);
+            }
+        }
+    }
+    // 日志中有记录（包括只剩不完整的一行）时压缩，新记录不会接在不完整的行后面
+    bool rewrite = replayed > 0 || migrated || !stale_files.empty();
+    for (const std::string &file_path : journal_files)
+    {
+        std::error_code error;
+        rewrite = rewrite || std::filesystem::file_size(file_path, error) > 0;
     }
 
-    std::ifstream file(index_file_path);
+    for (Shard &shard : shards)
+    {
+        // 容量变小时淘汰多出的条目（日志尚未打开，不记录）
+        bool evicted = false;
+        while (shard.entries.size() > shard.capacity && !shard.lru_list.empty())
+        {
+            evict_victim(shard);
+            evicted = true;
+        }
+
+        if (rewrite || evicted)
+        {
+            compact(shard);
+        }
+        if (!shard.journal.is_open())
+        {
+            shard.journal.open(shard.journal_file_path, std::ios::app);
+        }
+        if (!shard.journal.is_open())
+        {
+            std::cerr << "Warning: Could not open cache journal " << shard.journal_file_path << std::endl;
+        }
+    }
+
+    for (const std::string &file_path : stale_files)
+    {
+        std::filesystem::remove(file_path);
+    }
+
+    // 索引已指向各分片的当前段文件，删除其他段文件（上次压缩后未删除的旧文件、分片数改变前的文件）
+    // 以及旧版本每个键一个文件的paths目录
+    std::error_code error;
+    for (const auto &item : std::filesystem::directory_iterator(segments_dir, error))
+    {
+        bool current = false;
+        for (const Shard &shard : shards)
+        {
+            current = current || item.path() == std::filesystem::path(shard.segment_path);
+        }
+        if (!current)
+        {
+            std::filesystem::remove(item.path(), error);
+        }
+    }
+    std::filesystem::remove_all(cache_dir + "/paths", error);
+
+    for (Shard &shard : shards)
+    {
+        schedule_compaction(shard);
+    }
+}
+
+void PathCache::load_index_file(const std::string &file_path)
+{
+    std::ifstream file(file_path);
     if (!file.is_open())
     {
         return;
@@ -370,7 +1213,7 @@ void PathCache::load_index()
     // max_size: N
     // entry_count: M
     // lru_order: key1,key2,key3,...
-    // entry: key|start|end|csv_path|mtime|size|cache_file|created_time
+    // entry: key|start|end|csv_path|mtime|size|segment_file|created_time|offset|length|content|compute_cost
     // entry: ...
 
     std::string line;
@@ -407,100 +1250,123 @@ void PathCache::load_index()
             {
                 if (!key.empty())
                 {
-                    lru_list.push_back(key);
+                    shard_for(key).lru_list.push_back(key);
                 }
             }
         }
         else if (key_part == "entry")
         {
-            // 解析缓存条目
-            // 格式: key|start|end|csv_path|mtime|size|cache_file|created_time
-            std::stringstream ss(value_part);
-            std::vector<std::string> parts;
-            std::string part;
-            while (std::getline(ss, part, '|'))
-            {
-                parts.push_back(part);
-            }
-
-            if (parts.size() >= 7)
+            // 解析缓存条目，跳过无效条目（记录是否完整由attach_segment检查）
+            std::string key;
+            CacheEntry entry;
+            if (parse_entry(value_part, key, entry))
             {
-                std::string key = parts[0];
-                CacheEntry entry;
-                entry.start = parts[1];
-                entry.end = parts[2];
-                entry.csv_signature.path = parts[3];
-
-                try
-                {
-                    // 解析mtime
-                    long long mtime_count = std::stoll(parts[4]);
-                    entry.csv_signature.mtime = std::filesystem::file_time_type(
-                        std::filesystem::file_time_type::duration(mtime_count));
-
-                    // 解析size
-                    entry.csv_signature.size = std::stoull(parts[5]);
-
-                    entry.cache_file = parts[6];
-
-                    // 解析created_time（如果有）
-                    if (parts.size() >= 8)
-                    {
-                        long long created_time = std::stoll(parts[7]);
-                        entry.created_at = std::chrono::system_clock::time_point(
-                            std::chrono::system_clock::duration(created_time));
-                    }
-
-                    // 验证缓存文件是否存在
-                    if (std::filesystem::exists(entry.cache_file))
-                    {
-                        entries[key] = entry;
-                    }
-                }
-                catch (const std::exception &e)
-                {
-                    // 跳过无效条目
-                    continue;
-                }
+                shard_for(key).entries[key] = entry;
             }
         }
     }
 
     file.close();
+}
+
+size_t PathCache::replay_journal(const std::string &file_path)
+{
+    std::ifstream file(file_path, std::ios::binary);
+    if (!file.is_open())
+    {
+        return 0;
+    }
+    std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    // 只处理以换行结尾的完整记录，最后一行不完整说明写入时进程退出
+    size_t complete = content.rfind('\n');
+    if (complete == std::string::npos)
+    {
+        return 0;
+    }
 
-    // 清理LRU列表中不存在的条目
-    auto it = lru_list.begin();
-    while (it != lru_list.end())
+    size_t replayed = 0;
+    std::istringstream records(content.substr(0, complete + 1));
+    std::string line;
+    while (std::getline(records, line))
     {
-        if (entries.find(*it) == entries.end())
+        if (!line.empty() && line.back() == '\r')
+        {
+            line.pop_back();
+        }
+
+        size_t colon_pos = line.find(": ");
+        if (colon_pos == std::string::npos)
+        {
+            continue;
+        }
+        std::string type = line.substr(0, colon_pos);
+        std::string value = line.substr(colon_pos + 2);
+
+        if (type == "put")
+        {
+            std::string key;
+            CacheEntry entry;
+            if (!parse_entry(value, key, entry))
+            {
+                continue;
+            }
+            Shard &shard = shard_for(key);
+            auto it = shard.entries.find(key);
+            if (it != shard.entries.end())
+            {
+                unlink(shard, it);
+            }
+            link(shard, key, entry);
+        }
+        else if (type == "touch")
+        {
+            Shard &shard = shard_for(value);
+            auto it = shard.entries.find(value);
+            if (it != shard.entries.end())
+            {
+                shard.lru_list.splice(shard.lru_list.begin(), shard.lru_list, it->second.lru_position);
+            }
+        }
+        else if (type == "evict")
         {
-            it = lru_list.erase(it);
+            Shard &shard = shard_for(value);
+            auto it = shard.entries.find(value);
+            if (it != shard.entries.end())
+            {
+                unlink(shard, it);
+            }
         }
         else
         {
-            ++it;
+            continue;
         }
+        replayed++;
     }
+
+    return replayed;
 }
 
-void PathCache::save_index()
+bool PathCache::save_index(Shard &shard)
 {
-    std::ofstream file(index_file_path);
+    // 先写临时文件再替换，其他分片同时保存或进程中途退出时都不会留下写了一半的索引
+    std::string temp_file_path = shard.index_file_path + ".tmp";
+    std::ofstream file(temp_file_path);
     if (!file.is_open())
     {
-        std::cerr << "Error: Could not save cache index to " << index_file_path << std::endl;
-        return;
+        std::cerr << "Error: Could not save cache index to " << shard.index_file_path << std::endl;
+        return false;
     }
 
     // 写入元数据
     file << "# PathCache Index File\n";
-    file << "max_size: " << max_size << "\n";
-    file << "entry_count: " << entries.size() << "\n";
+    file << "max_size: " << shard.capacity << "\n";
+    file << "entry_count: " << shard.entries.size() << "\n";
 
     // 写入LRU顺序
     file << "lru_order: ";
     bool first = true;
-    for (const auto &key : lru_list)
+    for (const auto &key : shard.lru_list)
     {
         if (!first)
         {
@@ -512,20 +1378,26 @@ void PathCache::save_index()
     file << "\n";
 
     // 写入每个缓存条目
-    for (const auto &pair : entries)
+    for (const auto &pair : shard.entries)
     {
-        const std::string &key = pair.first;
-        const CacheEntry &entry = pair.second;
-
-        file << "entry: " << key << "|"
-             << entry.start << "|"
-             << entry.end << "|"
-             << entry.csv_signature.path << "|"
-             << entry.csv_signature.mtime.time_since_epoch().count() << "|"
-             << entry.csv_signature.size << "|"
-             << entry.cache_file << "|"
-             << entry.created_at.time_since_epoch().count() << "\n";
+        file << "entry: " << format_entry(pair.first, pair.second) << "\n";
     }
 
     file.close();
+    if (!file)
+    {
+        std::cerr << "Error: Could not save cache index to " << shard.index_file_path << std::endl;
+        return false;
+    }
+
+    try
+    {
+        std::filesystem::rename(temp_file_path, shard.index_file_path);
+    }
+    catch (const std::filesystem::filesystem_error &e)
+    {
+        std::cerr << "Error: Could not save cache index to " << shard.index_file_path << ": " << e.what() << std::endl;
+        return false;
+    }
+    return true;
 }
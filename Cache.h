@@ -4,27 +4,44 @@
 #include <string>
 #include <vector>
 #include <list>
+#include <memory>
+#include <fstream>
 #include <unordered_map>
 #include <filesystem>
 #include <chrono>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
 #include "Graph.h"  
+#include "FrequencySketch.h"
+#include "MappedFile.h"
+#include "ThreadPool.h"
 
 // 文件签名：使用修改时间和文件大小作为轻量级的文件变化检测
+// CacheConfig::content_keys启用时另外记录内容指纹，按内容区分文件：复制、重新下载或touch过的
+// 相同文件签名相同，不同路径下的相同地图共享缓存
 struct FileSignature
 {
     std::string path;   // 文件路径
     std::filesystem::file_time_type mtime;  // 修改时间
     uintmax_t size;     // 文件大小
+    std::string content;    // 内容指纹（XXH64），未启用content_keys或文件不存在时为空
 
-    FileSignature() : path(""), mtime(), size(0) {}
+    FileSignature() : path(""), mtime(), size(0), content("") {}
 
     FileSignature(const std::string &file_path);
 
-    // 检查文件是否仍然匹配当前签名（文件未被修改）
+    // 检查文件是否仍然匹配当前签名（文件未被修改；有内容指纹时比较内容）
     bool matches(const std::string &file_path) const;
 
-    // 将签名转换为字符串（用于生成缓存键）
+    // 将签名转换为字符串（用于生成缓存键），有内容指纹时只由内容决定
     std::string to_string() const;
+
+    // 将签名转换为16进制哈希串（用于按地图文件命名的预处理数据文件）
+    std::string to_key() const;
+
+    // 只由规范化路径生成的16进制哈希串，同一文件的各个版本相同（用于找出同一地图的旧预处理数据）
+    std::string path_key() const;
 };
 
 // 缓存条目
@@ -33,78 +50,190 @@ struct CacheEntry
     std::string start;  // 起点
     std::string end;    // 终点
     FileSignature csv_signature;
-    std::string cache_file; // 缓存文件路径
+    std::string cache_file; // 记录所在的段文件路径（旧版本为单独的缓存文件）
+    uint64_t offset;        // 记录在段文件中的偏移
+    uint64_t length;        // 记录的字节数，0表示旧版本的单独缓存文件（加载时迁移到段文件）
+    double compute_cost;    // 计算该结果花费的时间（毫秒），按代价淘汰时使用，未知为0
     std::chrono::system_clock::time_point created_at;   // 创建时间
+    std::list<std::string>::iterator lru_position;      // 键在所属分片LRU链表中的位置，移动和删除都是O(1)
+    bool in_window;                                     // TinyLFU：仍在窗口区（尚未经过准入判断）
+    std::list<std::string>::iterator window_position;   // in_window时键在窗口链表中的位置
 
-    CacheEntry() : start(""), end(""), csv_signature(), cache_file(""), created_at() {}
+    CacheEntry() : start(""), end(""), csv_signature(), cache_file(""), offset(0), length(0), compute_cost(0),
+                   created_at(), in_window(false) {}
 };
 
 // LRU缓存类
+// 条目按键的哈希分配到若干分片，每个分片有自己的互斥锁、LRU链表和索引文件，
+// 不同分片上的查询互不阻塞；命中/未命中计数为原子变量。可以被多个线程同时调用
+//
+// 每个分片的索引由两部分组成：
+//   cache_index_<分片号>.txt      最近一次压缩时的完整索引
+//   cache_index_<分片号>.journal  之后按顺序追加的记录，每行一条：
+//                                 put: <与索引文件entry行相同的字段>、touch: <键>、evict: <键>
+// put/命中/淘汰只追加一行，不重写索引；记录数达到阈值时压缩（重写完整索引并清空日志）。
+// 加载时先读完整索引再重放日志，进程中途退出留下的不完整的最后一行被忽略
+//
+// 路径数据不再每个键一个文件，而是追加到分片的段文件 segments/shard_<分片号>_<代号>.seg 中，
+// 条目记录偏移和长度，命中时通过内存映射读取。记录为带版本号的二进制格式（time/distance、
+// 三条路径的节点编号数组和共用的名字表），命中时不再逐行解析文本。
+// 淘汰和覆盖只让旧记录失效；失效的字节数超过CacheConfig::segment_compact_bytes且多于有效字节时，
+// 由后台线程把有效记录复制到下一代段文件，索引指向新文件后再删除旧文件
+//
+// 淘汰策略（CachePolicy）：
+//   LRU       放入前淘汰最久未使用的条目
+//   TINY_LFU  W-TinyLFU：新条目先进入占容量1%的窗口区；离开窗口时若分片已满，与主区的淘汰候选比较得分，
+//             得分更高才接纳，否则淘汰它自己。得分 = (Count-Min Sketch估计的访问频率 + 1) × 计算代价 / 记录字节数，
+//             主区的淘汰候选是LRU末尾若干条目中得分最低的。一次性扫描大量新起终点对不会冲掉常用路线，
+//             计算代价高的路线比同样常用的短路线保留得更久
 class PathCache
 {
 public:
     // cache_dir: 缓存目录路径
-    // max_size: LRU缓存最大条目数
-    PathCache(const std::string &cache_dir = ".cache", size_t max_size = 50);
+    // max_size: LRU缓存最大条目数（平均分给各分片，每个分片独立淘汰）
+    // shard_count: 分片数，不超过max_size
+    // policy: 淘汰策略
+    PathCache(const std::string &cache_dir = ".cache", size_t max_size = 50, size_t shard_count = 8,
+              CachePolicy policy = CachePolicy::LRU);
 
     // 查询缓存，返回MultiPath，如果未命中则所有路径为空
+    // hit: 可选，输出本次查询是否命中（多线程时不能再通过hit_count的变化判断）
     MultiPath get(const std::string &start,
                   const std::string &end,
-                  const std::string &csv_file);
+                  const std::string &csv_file,
+                  bool *hit = nullptr);
 
     // 保存到缓存（三种路径一起保存）
+    // compute_cost: 计算这些路径花费的时间（毫秒），TinyLFU策略按它加权
     void put(const std::string &start,
              const std::string &end,
              const std::string &csv_file,
-             const MultiPath &paths);
+             const MultiPath &paths,
+             double compute_cost = 0);
 
     // 清空所有缓存
     void clear();
 
     // 获取缓存统计信息
-    size_t get_hit_count() const { return hit_count; }
-    size_t get_miss_count() const { return miss_count; }
-    size_t get_entry_count() const { return entries.size(); }
+    size_t get_hit_count() const { return hit_count.load(); }
+    size_t get_miss_count() const { return miss_count.load(); }
+    size_t get_entry_count() const;
+    size_t get_rejected_count() const { return rejected_count.load(); }    // TinyLFU拒绝接纳的条目数
+    uint64_t get_bytes_saved() const { return bytes_saved.load(); }         // 命中时直接读出的记录字节数
+    double get_compute_saved_ms() const { return compute_saved_us.load() / 1000.0; }  // 命中条目的计算代价之和
+    CachePolicy get_policy() const { return policy; }
 
 private:
+    // 缓存分片：只有持有mutex时才能访问其余成员以及属于该分片的段文件
+    struct Shard
+    {
+        mutable std::mutex mutex;
+        std::list<std::string> lru_list;                      // 最近使用顺序，前面是最近使用的
+        std::unordered_map<std::string, CacheEntry> entries; // 键 -> 缓存条目
+        size_t capacity = 0;                                  // 本分片的最大条目数
+        std::string index_file_path;                          // cache_dir/cache_index_<分片号>.txt
+        std::string journal_file_path;                        // cache_dir/cache_index_<分片号>.journal
+        std::ofstream journal;                                // 以追加方式打开的日志
+        size_t journal_records = 0;                           // 上次压缩后追加的记录数
+        std::string segment_prefix;                           // cache_dir/segments/shard_<分片号>_
+        uint64_t generation = 0;                              // 当前段文件的代号，每次压缩加一
+        std::string segment_path;                             // 当前段文件 <segment_prefix><代号>.seg
+        std::ofstream segment;                                // 以追加方式打开的段文件
+        uint64_t segment_size = 0;                            // 段文件长度，包括已失效的记录
+        uint64_t live_bytes = 0;                              // 仍被条目引用的记录字节数
+        MappedFile mapped;                                    // 段文件的只读映射，记录超出映射范围时重新映射
+        bool compaction_queued = false;                       // 已提交后台压缩，尚未执行
+        std::list<std::string> window_list;                   // TinyLFU窗口区，前面是最近使用的
+        FrequencySketch sketch;                               // TinyLFU的访问频率估计
+    };
+
     std::string cache_dir;
-    std::string paths_dir;       // cache_dir/paths/
-    std::string index_file_path; // cache_dir/cache_index.txt
+    std::string segments_dir;    // cache_dir/segments/
     size_t max_size;
+    CachePolicy policy;
 
-    // LRU数据结构
-    std::list<std::string> lru_list;                      // 最近使用顺序，前面是最近使用的
-    std::unordered_map<std::string, CacheEntry> entries; // 键 -> 缓存条目
+    std::vector<Shard> shards;   // 构造后大小不变
 
     // 统计信息
-    size_t hit_count;
-    size_t miss_count;
+    std::atomic<size_t> hit_count;
+    std::atomic<size_t> miss_count;
+    std::atomic<size_t> rejected_count;
+    std::atomic<uint64_t> bytes_saved;
+    std::atomic<uint64_t> compute_saved_us;   // 微秒，整数才能原子累加
+
+    // 执行段文件压缩的后台线程，最后声明以便最先析构（等待剩余的压缩完成）
+    ThreadPool compactor;
 
     // 初始化缓存目录
     void init_cache_dir();
 
-    // 加载索引文件
+    // 键所在的分片
+    Shard &shard_for(const std::string &key);
+
+    // 加载缓存目录中的所有索引文件和日志（包括分片数不同时留下的和旧版的cache_index.txt），
+    // 条目按当前分片数重新分配；有日志记录或索引文件与当前分片不一致时压缩
     void load_index();
 
-    // 保存索引文件
-    void save_index();
+    // 读取一个完整索引文件，把条目放入所属的分片（LRU位置由load_index统一建立）
+    void load_index_file(const std::string &file_path);
+
+    // 重放一个日志文件，返回重放的记录数
+    size_t replay_journal(const std::string &file_path);
+
+    // 保存分片的完整索引（先写临时文件再替换，调用方持有分片的锁），成功返回true
+    bool save_index(Shard &shard);
+
+    // 压缩：保存完整索引后清空日志，索引保存失败时返回false
+    bool compact(Shard &shard);
+
+    // 追加一条日志记录，记录数达到阈值时压缩（日志未打开时忽略，例如加载期间）
+    void append_journal(Shard &shard, const std::string &record);
 
-    // 淘汰最久未使用的缓存条目
-    void evict_lru();
+    // 把条目放到分片LRU链表的最前面
+    void link(Shard &shard, const std::string &key, const CacheEntry &entry);
 
-    // 更新LRU顺序（将键移到最前面）
-    void touch(const std::string &key);
+    // 从分片中删除条目，记录在段文件中失效
+    void unlink(Shard &shard, std::unordered_map<std::string, CacheEntry>::iterator it);
+
+    // 删除条目并记录日志
+    void evict(Shard &shard, std::unordered_map<std::string, CacheEntry>::iterator it);
+
+    // 按淘汰策略淘汰分片中的一个条目
+    void evict_victim(Shard &shard);
+
+    // TinyLFU：条目的保留价值，越低越先淘汰
+    double score(Shard &shard, const std::string &key, const CacheEntry &entry);
+
+    // TinyLFU：主区（不在窗口中）LRU末尾若干条目中得分最低的，exclude不参与；没有时返回entries.end()
+    std::unordered_map<std::string, CacheEntry>::iterator select_victim(Shard &shard, const std::string *exclude);
+
+    // TinyLFU：窗口区超出容量时，离开窗口的条目按得分决定接纳或淘汰
+    void admit_from_window(Shard &shard);
+
+    // 更新LRU顺序（将条目移到最前面）
+    void touch(Shard &shard, CacheEntry &entry);
 
     // 生成缓存键
     std::string generate_key(const std::string &start,
                              const std::string &end,
                              const FileSignature &sig);
 
-    // 从缓存文件读取多路径
-    MultiPath read_cache_file(const std::string &file_path);
+    // 把记录追加到分片的段文件，成功时把位置写入entry
+    bool append_record(Shard &shard, const std::string &record, CacheEntry &entry);
+
+    // 通过内存映射读取条目的记录，记录不完整或段文件无法映射时返回false
+    bool read_record(Shard &shard, const CacheEntry &entry, MultiPath &paths);
+
+    // 加载时为分片选定段文件：沿用条目引用最多的本分片段文件，否则新建下一代；
+    // 不在该文件中的记录（旧版缓存文件、分片数改变前的段文件）复制过来，越界的条目丢弃。
+    // sources缓存其他段文件的映射。有条目被复制或丢弃时返回true
+    bool attach_segment(Shard &shard, std::unordered_map<std::string, std::unique_ptr<MappedFile>> &sources);
+
+    // 失效的字节超过阈值且多于有效字节时提交后台压缩（调用方持有分片的锁）
+    void schedule_compaction(Shard &shard);
 
-    // 写入多路径到缓存文件
-    void write_cache_file(const std::string &file_path, const MultiPath &paths);
+    // 把有效记录按LRU顺序复制到下一代段文件并保存索引，之后删除旧段文件（调用方持有分片的锁）
+    void compact_segment(Shard &shard);
 };
 
 #endif
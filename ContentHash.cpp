@@ -0,0 +1,218 @@
+#include "ContentHash.h"
+#include "MappedFile.h"
+#include <cstring>
+#include <filesystem>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+#include <unordered_map>
+
+#ifndef _WIN32
+#include <sys/stat.h>
+#endif
+
+namespace
+{
+    const uint64_t PRIME64_1 = 0x9E3779B185EBCA87ULL;
+    const uint64_t PRIME64_2 = 0xC2B2AE3D27D4EB4FULL;
+    const uint64_t PRIME64_3 = 0x165667B19E3779F9ULL;
+    const uint64_t PRIME64_4 = 0x85EBCA77C2B2AE63ULL;
+    const uint64_t PRIME64_5 = 0x27D4EB2F165667C5ULL;
+
+    uint64_t rotate_left(uint64_t value, int bits)
+    {
+        return (value << bits) | (value >> (64 - bits));
+    }
+
+    uint64_t read64(const unsigned char *bytes)
+    {
+        uint64_t value;
+        std::memcpy(&value, bytes, sizeof(value));
+        return value;
+    }
+
+    uint32_t read32(const unsigned char *bytes)
+    {
+        uint32_t value;
+        std::memcpy(&value, bytes, sizeof(value));
+        return value;
+    }
+
+    uint64_t mix_round(uint64_t accumulator, uint64_t input)
+    {
+        accumulator += input * PRIME64_2;
+        accumulator = rotate_left(accumulator, 31);
+        return accumulator * PRIME64_1;
+    }
+
+    uint64_t merge_round(uint64_t hash, uint64_t accumulator)
+    {
+        hash ^= mix_round(0, accumulator);
+        return hash * PRIME64_1 + PRIME64_4;
+    }
+
+    // 文件身份和版本：(设备号, inode, 修改时间, 大小)，无法取得时返回空串
+    std::string file_identity(const std::string &file_path)
+    {
+        std::ostringstream identity;
+#ifdef _WIN32
+        std::error_code error;
+        auto path = std::filesystem::canonical(file_path, error);
+        auto mtime = std::filesystem::last_write_time(file_path, error);
+        auto size = std::filesystem::file_size(file_path, error);
+        if (error)
+        {
+            return "";
+        }
+        identity << path.string() << "|" << mtime.time_since_epoch().count() << "|" << size;
+#else
+        struct stat file_stat;
+        if (stat(file_path.c_str(), &file_stat) != 0)
+        {
+            return "";
+        }
+        identity << file_stat.st_dev << "|" << file_stat.st_ino << "|" << file_stat.st_mtim.tv_sec << "."
+                 << file_stat.st_mtim.tv_nsec << "|" << file_stat.st_size;
+#endif
+        return identity.str();
+    }
+}
+
+Xxh64::Xxh64(uint64_t seed) : seed(seed), total_length(0), buffered(0)
+{
+    accumulators[0] = seed + PRIME64_1 + PRIME64_2;
+    accumulators[1] = seed + PRIME64_2;
+    accumulators[2] = seed;
+    accumulators[3] = seed - PRIME64_1;
+}
+
+void Xxh64::update(const void *data, size_t size)
+{
+    const unsigned char *input = static_cast<const unsigned char *>(data);
+    total_length += size;
+
+    // 先补满上次剩下的不完整块
+    if (buffered > 0)
+    {
+        size_t fill = std::min(size, sizeof(buffer) - buffered);
+        std::memcpy(buffer + buffered, input, fill);
+        buffered += fill;
+        input += fill;
+        size -= fill;
+        if (buffered < sizeof(buffer))
+        {
+            return;
+        }
+        for (int i = 0; i < 4; ++i)
+        {
+            accumulators[i] = mix_round(accumulators[i], read64(buffer + 8 * i));
+        }
+        buffered = 0;
+    }
+
+    // 整块处理：4个累加器各取8字节
+    uint64_t v0 = accumulators[0], v1 = accumulators[1], v2 = accumulators[2], v3 = accumulators[3];
+    for (; size >= 32; input += 32, size -= 32)
+    {
+        v0 = mix_round(v0, read64(input));
+        v1 = mix_round(v1, read64(input + 8));
+        v2 = mix_round(v2, read64(input + 16));
+        v3 = mix_round(v3, read64(input + 24));
+    }
+    accumulators[0] = v0;
+    accumulators[1] = v1;
+    accumulators[2] = v2;
+    accumulators[3] = v3;
+
+    std::memcpy(buffer, input, size);
+    buffered = size;
+}
+
+uint64_t Xxh64::digest() const
+{
+    uint64_t hash;
+    if (total_length >= 32)
+    {
+        hash = rotate_left(accumulators[0], 1) + rotate_left(accumulators[1], 7) +
+               rotate_left(accumulators[2], 12) + rotate_left(accumulators[3], 18);
+        for (int i = 0; i < 4; ++i)
+        {
+            hash = merge_round(hash, accumulators[i]);
+        }
+    }
+    else
+    {
+        hash = seed + PRIME64_5;
+    }
+    hash += total_length;
+
+    // 处理剩余的不足32字节
+    const unsigned char *tail = buffer;
+    size_t remaining = buffered;
+    for (; remaining >= 8; tail += 8, remaining -= 8)
+    {
+        hash ^= mix_round(0, read64(tail));
+        hash = rotate_left(hash, 27) * PRIME64_1 + PRIME64_4;
+    }
+    if (remaining >= 4)
+    {
+        hash ^= static_cast<uint64_t>(read32(tail)) * PRIME64_1;
+        hash = rotate_left(hash, 23) * PRIME64_2 + PRIME64_3;
+        tail += 4;
+        remaining -= 4;
+    }
+    for (; remaining > 0; ++tail, --remaining)
+    {
+        hash ^= *tail * PRIME64_5;
+        hash = rotate_left(hash, 11) * PRIME64_1;
+    }
+
+    // 雪崩
+    hash ^= hash >> 33;
+    hash *= PRIME64_2;
+    hash ^= hash >> 29;
+    hash *= PRIME64_3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+std::string content_fingerprint(const std::string &file_path)
+{
+    static std::mutex memo_mutex;
+    static std::unordered_map<std::string, std::string> memo;    // 文件身份 -> 指纹
+
+    std::string identity = file_identity(file_path);
+    if (identity.empty())
+    {
+        return "";
+    }
+    {
+        std::lock_guard<std::mutex> lock(memo_mutex);
+        auto it = memo.find(identity);
+        if (it != memo.end())
+        {
+            return it->second;
+        }
+    }
+
+    // 读取和哈希不持有锁，同一文件被多个线程同时计算时结果相同
+    MappedFile file;
+    if (!file.open(file_path))
+    {
+        return "";
+    }
+    Xxh64 hasher;
+    hasher.update(file.data(), file.size());
+
+    std::ostringstream oss;
+    oss << std::hex << std::setfill('0') << std::setw(16) << hasher.digest();
+    std::string fingerprint = oss.str();
+
+    // 哈希期间文件被修改时不记忆，下次重新计算
+    if (file_identity(file_path) == identity)
+    {
+        std::lock_guard<std::mutex> lock(memo_mutex);
+        memo[identity] = fingerprint;
+    }
+    return fingerprint;
+}
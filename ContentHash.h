@@ -0,0 +1,35 @@
+#ifndef CONTENT_HASH_H
+#define CONTENT_HASH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// 64位XXH64流式哈希（非加密）
+// 输入按32字节一块分给4个相互独立的累加器，没有数据依赖，CPU可以并行执行；
+// 结果与XXH64参考实现一致（按小端读取输入）
+class Xxh64
+{
+public:
+    explicit Xxh64(uint64_t seed = 0);
+
+    // 追加数据，可以多次调用
+    void update(const void *data, size_t size);
+
+    // 当前已追加数据的哈希值，不改变状态
+    uint64_t digest() const;
+
+private:
+    uint64_t seed;
+    uint64_t accumulators[4];
+    uint64_t total_length;
+    unsigned char buffer[32];   // 不足一块的剩余数据
+    size_t buffered;
+};
+
+// 文件内容的指纹：整个文件的XXH64，16位十六进制
+// 按(设备号, inode, 修改时间, 大小)在进程内记忆，文件未变化时不再重新读取；Windows上以规范化路径代替设备号和inode。
+// 文件无法读取时返回空串。可以被多个线程同时调用
+std::string content_fingerprint(const std::string &file_path);
+
+#endif // CONTENT_HASH_H
@@ -0,0 +1,221 @@
+#include "DynamicSSSP.h"
+#include <limits>
+#include <queue>
+#include <algorithm>
+
+DynamicSSSP::DynamicSSSP() : graph(nullptr), root(Graph::INVALID_ID), mode(WeightMode::TIME), touched(0), epoch(0)
+{
+}
+
+// 把节点计入本次处理的节点数（同一节点只计一次）
+void DynamicSSSP::touch(uint32_t v)
+{
+    if (touch_marks[v] != epoch)
+    {
+        touch_marks[v] = epoch;
+        touched++;
+    }
+}
+
+// 建立完整的最短路径树
+void DynamicSSSP::build(const Graph &source_graph, uint32_t source, WeightMode weight_mode)
+{
+    graph = &source_graph;
+    root = source;
+    mode = weight_mode;
+
+    topology_offsets = source_graph.get_offsets();
+    topology_targets = source_graph.get_edge_targets();
+    weight = source_graph.weights(weight_mode);
+
+    distances.assign(source_graph.node_count(), std::numeric_limits<double>::infinity());
+    parent_edges.assign(source_graph.node_count(), Graph::INVALID_ID);
+    touch_marks.assign(source_graph.node_count(), 0);
+    epoch = 1;
+    touched = 0;
+
+    std::vector<std::pair<double, uint32_t>> pending;
+    distances[source] = 0;
+    pending.push_back({0.0, source});
+    propagate(pending);
+}
+
+// 修复最短路径树
+bool DynamicSSSP::update(const Graph &next)
+{
+    if (graph == nullptr || next.get_offsets() != topology_offsets || next.get_edge_targets() != topology_targets)
+    {
+        return false;
+    }
+    graph = &next;
+    touched = 0;
+    if (++epoch == 0)
+    {
+        // 计数器回绕，重置标记
+        std::fill(touch_marks.begin(), touch_marks.end(), 0);
+        epoch = 1;
+    }
+
+    const double infinity = std::numeric_limits<double>::infinity();
+    const std::vector<double> &next_weight = next.weights(mode);
+    const std::vector<uint32_t> &sources = next.get_edge_sources();
+    const std::vector<uint32_t> &reverse_offsets = next.get_reverse_offsets();
+    const std::vector<uint32_t> &reverse_edges = next.get_reverse_edges();
+
+    // 找出权重变化的边，权重变大的树边的终点是失效子树的根
+    std::vector<uint32_t> decreased;
+    std::vector<uint32_t> invalid_roots;
+    for (uint32_t e = 0; e < weight.size(); ++e)
+    {
+        if (next_weight[e] == weight[e])
+        {
+            continue;
+        }
+        if (next_weight[e] < weight[e])
+        {
+            decreased.push_back(e);
+        }
+        else if (parent_edges[topology_targets[e]] == e)
+        {
+            invalid_roots.push_back(topology_targets[e]);
+        }
+    }
+    weight = next_weight;
+
+    // 收集失效子树（沿旧树的父子关系向下），距离置为无穷大
+    // 节点u的孩子是满足 parent_edges[v] 为u的出边的邻居v
+    std::vector<uint32_t> invalid;
+    for (uint32_t subtree_root : invalid_roots)
+    {
+        if (distances[subtree_root] == infinity)
+        {
+            continue;   // 已经在其他失效子树中
+        }
+        distances[subtree_root] = infinity;
+        invalid.push_back(subtree_root);
+        touch(subtree_root);
+
+        for (size_t i = invalid.size() - 1; i < invalid.size(); ++i)
+        {
+            uint32_t u = invalid[i];
+            for (uint32_t e = topology_offsets[u]; e < topology_offsets[u + 1]; ++e)
+            {
+                uint32_t v = topology_targets[e];
+                if (parent_edges[v] == e && distances[v] != infinity)
+                {
+                    distances[v] = infinity;
+                    invalid.push_back(v);
+                    touch(v);
+                }
+            }
+        }
+    }
+
+    // 失效节点的初始上界：来自有效入边邻居的最短距离
+    std::vector<std::pair<double, uint32_t>> pending;
+    for (uint32_t v : invalid)
+    {
+        parent_edges[v] = Graph::INVALID_ID;
+        for (uint32_t i = reverse_offsets[v]; i < reverse_offsets[v + 1]; ++i)
+        {
+            uint32_t e = reverse_edges[i];
+            double candidate = distances[sources[e]] + weight[e];
+            if (candidate < distances[v])
+            {
+                distances[v] = candidate;
+                parent_edges[v] = e;
+            }
+        }
+        if (parent_edges[v] != Graph::INVALID_ID)
+        {
+            pending.push_back({distances[v], v});
+        }
+    }
+
+    // 权重变小的边可能缩短终点的距离
+    for (uint32_t e : decreased)
+    {
+        uint32_t v = topology_targets[e];
+        double candidate = distances[sources[e]] + weight[e];
+        if (candidate < distances[v])
+        {
+            distances[v] = candidate;
+            parent_edges[v] = e;
+            pending.push_back({candidate, v});
+        }
+    }
+
+    propagate(pending);
+    return true;
+}
+
+// 从pending中的节点出发继续Dijkstra
+// 其他节点的距离都是可以达到的上界，并且除pending中的节点外，所有边都满足 d[v] <= d[u] + w(u, v)，
+// 因此只需从pending出发继续松弛即可得到新的最短距离
+void DynamicSSSP::propagate(std::vector<std::pair<double, uint32_t>> &pending)
+{
+    using QElement = std::pair<double, uint32_t>;
+    std::priority_queue<QElement, std::vector<QElement>, std::greater<QElement>> pq(
+        std::greater<QElement>(), std::move(pending));
+
+    while (!pq.empty())
+    {
+        double current_dist = pq.top().first;
+        uint32_t u = pq.top().second;
+        pq.pop();
+
+        if (current_dist > distances[u])
+        {
+            continue;
+        }
+        touch(u);
+
+        for (uint32_t e = topology_offsets[u]; e < topology_offsets[u + 1]; ++e)
+        {
+            uint32_t v = topology_targets[e];
+            double new_dist = current_dist + weight[e];
+            if (new_dist < distances[v])
+            {
+                distances[v] = new_dist;
+                parent_edges[v] = e;
+                pq.push({new_dist, v});
+            }
+        }
+    }
+}
+
+// 从树上取出到target的路径
+PathResult DynamicSSSP::path_to(uint32_t target) const
+{
+    PathResult result;
+    if (target != root && parent_edges[target] == Graph::INVALID_ID)
+    {
+        result.settled_nodes = touched;
+        return result;
+    }
+
+    result = graph->build_path_result(root, target, parent_edges);
+    result.settled_nodes = touched;
+    return result;
+}
+
+// 树中可达的节点数
+size_t DynamicSSSP::tree_size() const
+{
+    return static_cast<size_t>(std::count_if(distances.begin(), distances.end(), [](double d) {
+        return d != std::numeric_limits<double>::infinity();
+    }));
+}
+
+// 并行计算三种模式的最短路径
+MultiPath DynamicEngine::find_multi_path(const Graph &graph, const std::string &start, const std::string &end)
+{
+    return graph.find_multi_path(start, end, [this, &graph](uint32_t source, uint32_t target, WeightMode mode) {
+        DynamicSSSP &tree = trees[static_cast<int>(mode)];
+        if (!tree.is_rooted_at(source) || !tree.update(graph))
+        {
+            tree.build(graph, source, mode);
+        }
+        return tree.path_to(target);
+    });
+}
@@ -0,0 +1,80 @@
+#ifndef DYNAMIC_SSSP_H
+#define DYNAMIC_SSSP_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Graph.h"
+#include "config.h"
+
+// 动态单源最短路径（dynamic Dijkstra，思路同 Ramalingam–Reps）
+// 对同一个起点保存一棵完整的最短路径树。换到下一个快照时，先找出权重变化的边：
+//   权重变大的树边：其终点所在的整棵子树的距离失效，先置为无穷大，
+//                 再用子树外入边邻居的距离给出初始上界
+//   权重变小的边：  若能缩短终点的距离，直接更新
+// 然后从这些节点出发继续做Dijkstra，只有受影响的节点会被处理
+class DynamicSSSP
+{
+public:
+    DynamicSSSP();
+
+    // 在graph上以source为根、mode为权重建立完整的最短路径树
+    void build(const Graph &graph, uint32_t source, WeightMode mode);
+
+    // 已经以source为根建立了最短路径树
+    bool is_rooted_at(uint32_t source) const { return graph != nullptr && root == source; }
+
+    // graph换成下一个快照后修复最短路径树
+    // graph的拓扑必须与建树时一致，不一致时返回false，需要重新build
+    bool update(const Graph &graph);
+
+    // 从树上取出到target的路径（settled_nodes为最近一次build/update处理的节点数）
+    PathResult path_to(uint32_t target) const;
+
+    // 最近一次build/update处理（失效或出队确定）的不同节点数
+    size_t touched_nodes() const { return touched; }
+
+    // 树中可达的节点数，即完整重算一次需要确定的节点数
+    size_t tree_size() const;
+
+private:
+    const Graph *graph;         // 最近一次build/update使用的快照
+    uint32_t root;
+    WeightMode mode;
+    size_t touched;
+
+    // 建树时的拓扑和上一个快照的权重，用于找出变化的边
+    std::vector<uint32_t> topology_offsets;
+    std::vector<uint32_t> topology_targets;
+    std::vector<double> weight;
+
+    std::vector<double> distances;
+    std::vector<uint32_t> parent_edges;     // 树中每个节点的入边，根和不可达节点为INVALID_ID
+
+    // 统计处理过的不同节点数：touch_marks[v] == epoch 表示v在本次build/update中已被计数
+    std::vector<uint32_t> touch_marks;
+    uint32_t epoch;
+
+    // 把节点计入本次处理的节点数
+    void touch(uint32_t v);
+
+    // 从pending中的节点出发继续Dijkstra
+    void propagate(std::vector<std::pair<double, uint32_t>> &pending);
+};
+
+// 三种权重模式的动态最短路径树，跨快照保存在调用方
+class DynamicEngine
+{
+public:
+    // 并行计算三种模式的最短路径：树的根与起点相同且拓扑不变时修复旧树，否则重新建树
+    // 每种模式在自己的线程上只访问自己的树
+    MultiPath find_multi_path(const Graph &graph, const std::string &start, const std::string &end);
+
+    // 指定模式的树，用于统计
+    const DynamicSSSP &tree(WeightMode mode) const { return trees[static_cast<int>(mode)]; }
+
+private:
+    DynamicSSSP trees[3];   // 按 TIME/DISTANCE/BALANCED 下标存放
+};
+
+#endif // DYNAMIC_SSSP_H
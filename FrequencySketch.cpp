@@ -0,0 +1,67 @@
+#include "FrequencySketch.h"
+#include <algorithm>
+
+namespace
+{
+    // 每行使用不同的奇数乘子，把同一个哈希映射到不相关的位置
+    const uint64_t ROW_SEEDS[4] = {0x9E3779B97F4A7C15ULL, 0xC2B2AE3D27D4EB4FULL,
+                                   0x165667B19E3779F9ULL, 0x85EBCA77C2B2AE63ULL};
+}
+
+FrequencySketch::FrequencySketch(size_t expected_keys) : width(64), additions(0)
+{
+    while (width < expected_keys)
+    {
+        width <<= 1;
+    }
+    counters.assign(DEPTH * width, 0);
+    sample_size = 10 * width;
+}
+
+size_t FrequencySketch::index_of(uint64_t hash, int row) const
+{
+    uint64_t mixed = (hash ^ (hash >> 29)) * ROW_SEEDS[row];
+    return row * width + static_cast<size_t>((mixed >> 32) & (width - 1));
+}
+
+void FrequencySketch::increment(uint64_t hash)
+{
+    // 只增加最小的计数器（保守更新），减小碰撞带来的高估
+    unsigned minimum = estimate(hash);
+    if (minimum < MAX_COUNT)
+    {
+        for (int row = 0; row < DEPTH; ++row)
+        {
+            uint8_t &counter = counters[index_of(hash, row)];
+            if (counter == minimum)
+            {
+                counter++;
+            }
+        }
+    }
+
+    if (++additions >= sample_size)
+    {
+        for (uint8_t &counter : counters)
+        {
+            counter >>= 1;
+        }
+        additions /= 2;
+    }
+}
+
+unsigned FrequencySketch::estimate(uint64_t hash) const
+{
+    unsigned minimum = MAX_COUNT;
+    for (int row = 0; row < DEPTH; ++row)
+    {
+        minimum = std::min<unsigned>(minimum, counters[index_of(hash, row)]);
+    }
+    return minimum;
+}
+
+void FrequencySketch::clear()
+{
+    std::fill(counters.begin(), counters.end(), 0);
+    additions = 0;
+}
@@ -0,0 +1,40 @@
+#ifndef FREQUENCY_SKETCH_H
+#define FREQUENCY_SKETCH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 估计键访问频率的Count-Min Sketch（TinyLFU准入使用）
+// 4行计数器，每行按不同的哈希选一个位置，估计值取4个计数器的最小值；计数器上限为15。
+// 累计增加的次数达到10倍宽度时所有计数器减半，使频率反映近期的访问而不是全部历史。
+// 不加锁，由调用方保证互斥
+class FrequencySketch
+{
+public:
+    // expected_keys: 预计同时跟踪的键数，每行宽度取不小于它的2的幂（至少64）
+    explicit FrequencySketch(size_t expected_keys = 0);
+
+    // 记录键的一次访问
+    void increment(uint64_t hash);
+
+    // 键的访问频率估计（0~15）
+    unsigned estimate(uint64_t hash) const;
+
+    // 清空所有计数
+    void clear();
+
+private:
+    static const int DEPTH = 4;
+    static const uint8_t MAX_COUNT = 15;
+
+    std::vector<uint8_t> counters;  // DEPTH行，每行width个
+    size_t width;                   // 每行宽度，2的幂
+    size_t additions;               // 上次减半后增加的次数
+    size_t sample_size;             // additions达到该值时减半
+
+    // 第row行中键的位置
+    size_t index_of(uint64_t hash, int row) const;
+};
+
+#endif // FREQUENCY_SKETCH_H
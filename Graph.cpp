@@ -1,333 +1,1992 @@
 #include "Graph.h"
 #include "util.h"
+#include "PriorityQueue.h"
+#include "MappedFile.h"
+#include "ThreadPool.h"
 #include <iostream>
 #include <fstream>
-#include <sstream>
+#include <cstring>
+#include <charconv>
+#include <string_view>
 #include <limits>
-#include <queue>
+#include <cmath>
 #include <vector>
 #include <algorithm>
+#include <thread>
+#include <filesystem>
+#include <random>
 
-Graph::Graph()
+namespace
 {
+    // 二进制快照的魔数和版本
+    const char GRAPH_FILE_MAGIC[4] = {'G', 'R', 'F', '2'};
+
+    // 可达性索引保存传递闭包的最大分量数（位图占 分量数^2/8 字节，8192个分量为8 MB）
+    const size_t REACH_CLOSURE_MAX_COMPONENTS = 8192;
+
+    // 二进制快照的文件头，之后依次存放：
+    // 节点名表 | offsets [node_count + 1] |
+    // edge_sources | edge_targets | edge_lengths | edge_speed_limits | edge_lanes | edge_vehicles |
+    // edge_times | edge_balanced_scores（各 [edge_count]）| reverse_offsets [node_count + 1] | reverse_edges [edge_count] |
+    // 道路ID表 | row_edges [row_count * 2]
+    // 字符串表的格式为：偏移 [count + 1] | 拼接在一起的字节
+    struct GraphFileHeader
+    {
+        char magic[4];
+        uint32_t node_count;
+        uint32_t edge_count;
+        uint32_t row_count;
+        uint32_t name_bytes;
+        uint32_t road_id_bytes;
+        double bpr_alpha;           // 计算time时使用的参数
+        double bpr_beta;
+        double lane_capacity;
+        double time_factor;         // 计算balanced_score时使用的参数
+        double distance_factor;
+    };
+
+    template <typename T>
+    void write_array(std::ofstream &file, const std::vector<T> &values)
+    {
+        file.write(reinterpret_cast<const char *>(values.data()), values.size() * sizeof(T));
+    }
+
+    // 字符串表：把字符串拼接成一段连续字节，另存每个字符串的起始偏移
+    void write_strings(std::ofstream &file, const std::vector<std::string> &strings)
+    {
+        std::vector<uint32_t> string_offsets(strings.size() + 1, 0);
+        std::string bytes;
+        for (size_t i = 0; i < strings.size(); ++i)
+        {
+            bytes += strings[i];
+            string_offsets[i + 1] = static_cast<uint32_t>(bytes.size());
+        }
+
+        write_array(file, string_offsets);
+        file.write(bytes.data(), bytes.size());
+    }
+
+    // 计算字符串表的总字节数（写入文件头时需要先知道）
+    uint32_t string_bytes(const std::vector<std::string> &strings)
+    {
+        size_t total = 0;
+        for (const std::string &value : strings)
+        {
+            total += value.size();
+        }
+        return static_cast<uint32_t>(total);
+    }
+
+    // 从映射的内存中顺序读取count个元素，剩余字节不足时返回false
+    template <typename T>
+    bool read_array(std::string_view &content, std::vector<T> &values, size_t count)
+    {
+        if (content.size() / sizeof(T) < count)
+        {
+            return false;
+        }
+        values.resize(count);
+        std::memcpy(values.data(), content.data(), count * sizeof(T));
+        content.remove_prefix(count * sizeof(T));
+        return true;
+    }
+
+    // 读取count个字符串组成的字符串表，偏移不合法或数据不足时返回false
+    bool read_strings(std::string_view &content, std::vector<std::string> &strings, size_t count, size_t bytes)
+    {
+        std::vector<uint32_t> string_offsets;
+        if (!read_array(content, string_offsets, count + 1) || string_offsets[count] != bytes || content.size() < bytes)
+        {
+            return false;
+        }
+
+        // 先检查整张偏移表单调不减，所有字符串都在表内
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (string_offsets[i + 1] < string_offsets[i])
+            {
+                return false;
+            }
+        }
+
+        strings.clear();
+        strings.reserve(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            strings.emplace_back(content.data() + string_offsets[i], string_offsets[i + 1] - string_offsets[i]);
+        }
+        content.remove_prefix(bytes);
+        return true;
+    }
+
+    // CSV中各列的下标，不存在的列为-1
+    struct CsvColumns
+    {
+        int road_id = -1;           // 可选列
+        int start_node = -1;
+        int end_node = -1;
+        int direction = -1;
+        int length = -1;
+        int speed_limit = -1;
+        int lanes = -1;
+        int vehicles = -1;
+    };
+
+    // 一行道路记录中的数值字段
+    struct RoadValues
+    {
+        double length;
+        double speed_limit;
+        int lanes;
+        int current_vehicles;
+    };
+
+    // 从content中取出下一行（去掉行尾的回车符），content前进到下一行的开头
+    bool next_line(std::string_view &content, std::string_view &line)
+    {
+        if (content.empty())
+        {
+            return false;
+        }
+
+        size_t end = content.find('\n');
+        if (end == std::string_view::npos)
+        {
+            line = content;
+            content = std::string_view();
+        }
+        else
+        {
+            line = content.substr(0, end);
+            content.remove_prefix(end + 1);
+        }
+
+        if (!line.empty() && line.back() == '\r')
+        {
+            line.remove_suffix(1);
+        }
+        return true;
+    }
+
+    // 按逗号切分一行，字段指向line内部
+    void split_fields(std::string_view line, std::vector<std::string_view> &fields)
+    {
+        fields.clear();
+        while (true)
+        {
+            size_t comma = line.find(',');
+            if (comma == std::string_view::npos)
+            {
+                // 与getline的行为一致：行尾的空字段不计入
+                if (!line.empty())
+                {
+                    fields.push_back(line);
+                }
+                return;
+            }
+            fields.push_back(line.substr(0, comma));
+            line.remove_prefix(comma + 1);
+        }
+    }
+
+    // 解析数值字段，不抛出异常
+    // 与stod/stoi一样允许前导空白和正号，但整个字段（除去首尾空白）必须是一个合法的数
+    template <typename T>
+    std::errc parse_number(std::string_view field, T &value)
+    {
+        while (!field.empty() && (field.front() == ' ' || field.front() == '\t'))
+        {
+            field.remove_prefix(1);
+        }
+        while (!field.empty() && (field.back() == ' ' || field.back() == '\t'))
+        {
+            field.remove_suffix(1);
+        }
+        if (!field.empty() && field.front() == '+')
+        {
+            field.remove_prefix(1);
+        }
+
+        const char *last = field.data() + field.size();
+        std::from_chars_result result = std::from_chars(field.data(), last, value);
+        if (result.ec == std::errc() && result.ptr != last)
+        {
+            return std::errc::invalid_argument;
+        }
+        return result.ec;
+    }
+
+    // 根据表头动态确定列索引，缺少必需的列时返回false
+    bool resolve_columns(const std::vector<std::string_view> &headers, CsvColumns &columns)
+    {
+        for (int i = 0; i < static_cast<int>(headers.size()); ++i)
+        {
+            if (headers[i] == "道路ID") columns.road_id = i;
+            else if (headers[i] == "起始地点") columns.start_node = i;
+            else if (headers[i] == "目标地点") columns.end_node = i;
+            else if (headers[i] == "道路方向") columns.direction = i;
+            else if (headers[i] == "道路长度(米)") columns.length = i;
+            else if (headers[i] == "道路限速(km/h)") columns.speed_limit = i;
+            else if (headers[i] == "车道数") columns.lanes = i;
+            else if (headers[i] == "现有车辆数") columns.vehicles = i;
+        }
+
+        return columns.start_node != -1 && columns.end_node != -1 && columns.direction != -1 &&
+               columns.length != -1 && columns.speed_limit != -1 && columns.lanes != -1 && columns.vehicles != -1;
+    }
+
+    // 解析一行中的数值字段
+    std::errc parse_road_values(const std::vector<std::string_view> &fields, const CsvColumns &columns, RoadValues &values)
+    {
+        std::errc status = parse_number(fields[columns.length], values.length);
+        if (status == std::errc())
+            status = parse_number(fields[columns.speed_limit], values.speed_limit);
+        if (status == std::errc())
+            status = parse_number(fields[columns.lanes], values.lanes);
+        if (status == std::errc())
+            status = parse_number(fields[columns.vehicles], values.current_vehicles);
+        return status;
+    }
+}
+
+Graph::Graph() : weight_range{0.0, 0.0, 0.0, 0.0}, component_total(0), reach_words(0)
+{
+}
+
+// 从CSV文件加载地图数据来构建图
+bool Graph::from_csv(const std::string &filename)
+{
+    // 整个文件映射到内存，字段以string_view的形式原地切分，不复制行内容
+    MappedFile file;
+    if (!file.open(filename))
+    {
+        std::cerr << "Error: Could not open file " << filename << std::endl;
+        return false;
+    }
+
+    // 清空旧的图数据，以便加载新地图
+    node_names.clear();
+    node_ids.clear();
+    offsets.clear();
+    reverse_offsets.clear();
+    reverse_edges.clear();
+    edge_sources.clear();
+    edge_targets.clear();
+    edge_lengths.clear();
+    edge_speed_limits.clear();
+    edge_lanes.clear();
+    edge_vehicles.clear();
+    edge_times.clear();
+    edge_balanced_scores.clear();
+    road_ids.clear();
+    row_edges.clear();
+    node_components.clear();
+    component_reach.clear();
+    component_low.clear();
+    component_post.clear();
+    component_total = 0;
+    reach_words = 0;
+
+    // 按读入顺序暂存的边，全部读完后再整理成CSR
+    std::vector<Edge> raw_edges;
+
+    std::string_view content = file.view();
+    std::string_view line;
+
+    // 读取并解析表头
+    if (!next_line(content, line))
+    {
+        std::cerr << "Error: Could not read header line from " << filename << std::endl;
+        return false;
+    }
+
+    std::vector<std::string_view> headers;
+    split_fields(line, headers);
+
+    // 动态确定列索引，检查是否所有必需的列都已找到
+    CsvColumns columns;
+    if (!resolve_columns(headers, columns))
+    {
+        std::cerr << "Error: CSV file " << filename << " is missing one or more required columns." << std::endl;
+        return false;
+    }
+
+    // 逐行解析文件内容
+    // fields和name_key在各行之间复用，解析过程中不再为每行分配内存
+    std::vector<std::string_view> fields;
+    std::string name_key;
+    int line_number = 1; // 表头已读取
+    while (next_line(content, line))
+    {
+        line_number++;
+        split_fields(line, fields);
+
+        // 每个数据行都占一个行号，被跳过的行不对应任何边
+        road_ids.emplace_back();
+        row_edges.push_back(INVALID_ID);
+        row_edges.push_back(INVALID_ID);
+
+        if (fields.size() < headers.size())
+        {
+            // 跳过格式不正确的行
+            continue;
+        }
+
+        RoadValues values;
+        std::errc status = parse_road_values(fields, columns, values);
+        if (status == std::errc::result_out_of_range)
+        {
+            std::cerr << "Warning: Data out of range at line " << line_number << " in " << filename << ", skipping this line." << std::endl;
+            continue;
+        }
+        if (status != std::errc())
+        {
+            std::cerr << "Warning: Invalid data format at line " << line_number << " in " << filename << ", skipping this line." << std::endl;
+            continue;
+        }
+
+        if (columns.road_id != -1)
+        {
+            road_ids.back().assign(fields[columns.road_id]);
+        }
+
+        // 地点名只在这里哈希一次，之后全部使用整数ID
+        name_key.assign(fields[columns.start_node]);
+        uint32_t start_id = intern_node(name_key);
+        name_key.assign(fields[columns.end_node]);
+        uint32_t end_id = intern_node(name_key);
+
+        // 使用Edge的构造函数创建边，先记下它在raw_edges中的下标，整理成CSR后再换成边ID
+        row_edges[row_edges.size() - 2] = static_cast<uint32_t>(raw_edges.size());
+        raw_edges.emplace_back(start_id, end_id, values.length, values.speed_limit, values.lanes, values.current_vehicles);
+
+        // 如果是双向路，则添加反向的边
+        if (fields[columns.direction] == "双向")
+        {
+            row_edges.back() = static_cast<uint32_t>(raw_edges.size());
+            raw_edges.emplace_back(end_id, start_id, values.length, values.speed_limit, values.lanes, values.current_vehicles);
+        }
+    }
+
+    file.close();
+
+    // 按起点做计数排序，构建CSR邻接表（同一起点的出边保持读入顺序）
+    size_t node_total = node_names.size();
+    size_t edge_total = raw_edges.size();
+    offsets.assign(node_total + 1, 0);
+    for (const Edge &raw : raw_edges)
+    {
+        offsets[raw.source + 1]++;
+    }
+    for (size_t i = 0; i < node_total; ++i)
+    {
+        offsets[i + 1] += offsets[i];
+    }
+
+    // 把每条边的属性拆分到各自的列中
+    edge_sources.resize(edge_total);
+    edge_targets.resize(edge_total);
+    edge_lengths.resize(edge_total);
+    edge_speed_limits.resize(edge_total);
+    edge_lanes.resize(edge_total);
+    edge_vehicles.resize(edge_total);
+    edge_times.resize(edge_total);
+    edge_balanced_scores.resize(edge_total);
+
+    std::vector<uint32_t> cursor(offsets.begin(), offsets.end() - 1);
+    std::vector<uint32_t> raw_to_edge(edge_total);
+    for (size_t k = 0; k < edge_total; ++k)
+    {
+        const Edge &raw = raw_edges[k];
+        uint32_t e = cursor[raw.source]++;
+        raw_to_edge[k] = e;
+        edge_sources[e] = raw.source;
+        edge_targets[e] = raw.destination;
+        edge_lengths[e] = raw.length;
+        edge_speed_limits[e] = raw.speed_limit;
+        edge_lanes[e] = raw.lanes;
+        edge_vehicles[e] = raw.current_vehicles;
+    }
+
+    for (uint32_t &e : row_edges)
+    {
+        if (e != INVALID_ID)
+        {
+            e = raw_to_edge[e];
+        }
+    }
+
+    // 构建反向CSR：按终点对正向边ID做计数排序
+    reverse_offsets.assign(node_total + 1, 0);
+    for (uint32_t target : edge_targets)
+    {
+        reverse_offsets[target + 1]++;
+    }
+    for (size_t i = 0; i < node_total; ++i)
+    {
+        reverse_offsets[i + 1] += reverse_offsets[i];
+    }
+
+    reverse_edges.resize(edge_total);
+    std::vector<uint32_t> reverse_cursor(reverse_offsets.begin(), reverse_offsets.end() - 1);
+    for (size_t e = 0; e < edge_total; ++e)
+    {
+        reverse_edges[reverse_cursor[edge_targets[e]]++] = static_cast<uint32_t>(e);
+    }
+
+    if (SearchConfig::reachability)
+    {
+        build_reachability();
+    }
+
+    // 检查是否成功加载了边
+    if (edge_total == 0)
+    {
+        std::cerr << "Warning: No valid edges loaded from " << filename << ". The graph is empty." << std::endl;
+        return true;
+    }
+
+    // 计算所有边的time字段
+    for (size_t e = 0; e < edge_total; ++e)
+    {
+        edge_times[e] = calculate_travel_time(edge_lengths[e], edge_speed_limits[e], edge_lanes[e], edge_vehicles[e]);
+    }
+
+    // 计算时间和距离的范围用于归一化
+    weight_range = calculate_weight_range();
+
+    // 计算balanced_score
+    for (size_t e = 0; e < edge_total; ++e)
+    {
+        edge_balanced_scores[e] = calculate_balanced_score(e);
+    }
+
+    return true;
+}
+
+// 增量加载下一个快照：只核对拓扑并记下车辆数变化的行，确认可以增量更新后再由apply_snapshot修改图数据
+bool Graph::compare_snapshot(const std::string &filename, SnapshotDelta &delta) const
+{
+    delta.updates.clear();
+    if (edge_targets.empty())
+    {
+        return false;
+    }
+
+    MappedFile file;
+    if (!file.open(filename))
+    {
+        return false;
+    }
+
+    std::string_view content = file.view();
+    std::string_view line;
+    if (!next_line(content, line))
+    {
+        return false;
+    }
+
+    std::vector<std::string_view> headers;
+    split_fields(line, headers);
+    CsvColumns columns;
+    if (!resolve_columns(headers, columns))
+    {
+        return false;
+    }
+
+    // 逐行核对道路ID、起终点、方向和静态属性，记录车辆数变化的行
+    std::vector<std::string_view> fields;
+    const size_t row_total = road_ids.size();
+    size_t row = 0;
+    while (next_line(content, line))
+    {
+        if (row >= row_total)
+        {
+            return false;
+        }
+
+        split_fields(line, fields);
+        uint32_t e = row_edges[2 * row];
+        uint32_t reverse = row_edges[2 * row + 1];
+
+        RoadValues values;
+        bool valid = fields.size() >= headers.size() && parse_road_values(fields, columns, values) == std::errc();
+        if (!valid || e == INVALID_ID)
+        {
+            // 两个快照中都被跳过的行不影响拓扑
+            if (valid || e != INVALID_ID)
+            {
+                return false;
+            }
+            row++;
+            continue;
+        }
+
+        std::string_view road_id = columns.road_id != -1 ? fields[columns.road_id] : std::string_view();
+        bool two_way = fields[columns.direction] == "双向";
+        if (road_id != road_ids[row] ||
+            fields[columns.start_node] != node_names[edge_sources[e]] ||
+            fields[columns.end_node] != node_names[edge_targets[e]] ||
+            two_way != (reverse != INVALID_ID) ||
+            values.length != edge_lengths[e] || values.speed_limit != edge_speed_limits[e] ||
+            values.lanes != edge_lanes[e])
+        {
+            return false;
+        }
+
+        if (values.current_vehicles != edge_vehicles[e])
+        {
+            delta.updates.push_back({row, values.current_vehicles});
+        }
+        row++;
+    }
+
+    return row == row_total;
+}
+
+// 应用增量：只更新变化的边，同时判断time的范围是否可能收缩
+// 原来取到最小值（最大值）的边变大（变小）后，新的范围只能通过重新扫描得到
+void Graph::apply_snapshot(const SnapshotDelta &delta, std::vector<uint32_t> &changed_edges)
+{
+    changed_edges.clear();
+    bool rescan_range = false;
+    WeightRange range = weight_range;
+    for (const auto &[changed_row, vehicles] : delta.updates)
+    {
+        for (uint32_t e : {row_edges[2 * changed_row], row_edges[2 * changed_row + 1]})
+        {
+            if (e == INVALID_ID)
+            {
+                continue;
+            }
+
+            double old_time = edge_times[e];
+            edge_vehicles[e] = vehicles;
+            edge_times[e] = calculate_travel_time(edge_lengths[e], edge_speed_limits[e], edge_lanes[e], vehicles);
+            changed_edges.push_back(e);
+
+            if ((old_time == weight_range.time_min && edge_times[e] > old_time) ||
+                (old_time == weight_range.time_max && edge_times[e] < old_time))
+            {
+                rescan_range = true;
+            }
+            if (std::isfinite(edge_times[e]))
+            {
+                range.time_min = std::min(range.time_min, edge_times[e]);
+                range.time_max = std::max(range.time_max, edge_times[e]);
+            }
+        }
+    }
+
+    if (rescan_range)
+    {
+        range = calculate_weight_range();
+    }
+
+    // 范围不变时只重新计算变化的边的综合评分，否则所有边都要重新归一化
+    if (range.time_min == weight_range.time_min && range.time_max == weight_range.time_max)
+    {
+        for (uint32_t e : changed_edges)
+        {
+            edge_balanced_scores[e] = calculate_balanced_score(e);
+        }
+    }
+    else
+    {
+        weight_range = range;
+        for (size_t e = 0; e < edge_balanced_scores.size(); ++e)
+        {
+            edge_balanced_scores[e] = calculate_balanced_score(e);
+        }
+    }
+}
+
+// 计算一条边的综合评分：时间和距离按weight_range归一化后加权平均
+double Graph::calculate_balanced_score(size_t e) const
+{
+    // 不可通行的道路（time为无穷大）综合评分也是无穷大
+    if (!std::isfinite(edge_times[e]))
+    {
+        return std::numeric_limits<double>::infinity();
+    }
+
+    double normalized_time = 0.0;
+    double normalized_distance = 0.0;
+
+    // 归一化
+    if (weight_range.time_max > weight_range.time_min)
+    {
+        normalized_time = (edge_times[e] - weight_range.time_min) / (weight_range.time_max - weight_range.time_min);
+    }
+
+    if (weight_range.distance_max > weight_range.distance_min)
+    {
+        normalized_distance = (edge_lengths[e] - weight_range.distance_min) / (weight_range.distance_max - weight_range.distance_min);
+    }
+
+    // 加权平均
+    return PathWeightConfig::time_factor * normalized_time +
+           PathWeightConfig::distance_factor * normalized_distance;
+}
+
+// 将解析好的图写入二进制快照
+bool Graph::save_binary(const std::string &filename) const
+{
+    // 先写临时文件再替换：其他线程或进程可能正映射着同名快照，原地截断重写会让它们读到半截数据甚至SIGBUS
+    // 临时文件名带随机后缀，同时保存同一张图的多个进程、线程互不干扰
+    std::string temp_filename = filename + "." + std::to_string(std::random_device()()) + ".tmp";
+    std::ofstream file(temp_filename, std::ios::binary | std::ios::trunc);
+    if (!file.is_open())
+    {
+        std::cerr << "Error: Could not save graph snapshot to " << filename << std::endl;
+        return false;
+    }
+
+    GraphFileHeader header;
+    std::memcpy(header.magic, GRAPH_FILE_MAGIC, sizeof(header.magic));
+    header.node_count = static_cast<uint32_t>(node_names.size());
+    header.edge_count = static_cast<uint32_t>(edge_targets.size());
+    header.row_count = static_cast<uint32_t>(road_ids.size());
+    header.name_bytes = string_bytes(node_names);
+    header.road_id_bytes = string_bytes(road_ids);
+    header.bpr_alpha = BPRConfig::alpha;
+    header.bpr_beta = BPRConfig::beta;
+    header.lane_capacity = BPRConfig::lane_capacity;
+    header.time_factor = PathWeightConfig::time_factor;
+    header.distance_factor = PathWeightConfig::distance_factor;
+
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    write_strings(file, node_names);
+    write_array(file, offsets);
+    write_array(file, edge_sources);
+    write_array(file, edge_targets);
+    write_array(file, edge_lengths);
+    write_array(file, edge_speed_limits);
+    write_array(file, edge_lanes);
+    write_array(file, edge_vehicles);
+    write_array(file, edge_times);
+    write_array(file, edge_balanced_scores);
+    write_array(file, reverse_offsets);
+    write_array(file, reverse_edges);
+    write_strings(file, road_ids);
+    write_array(file, row_edges);
+
+    file.close();
+    std::error_code error;
+    if (file)
+    {
+        std::filesystem::rename(temp_filename, filename, error);
+    }
+    if (!file || error)
+    {
+        std::cerr << "Error: Could not save graph snapshot to " << filename << std::endl;
+        std::filesystem::remove(temp_filename, error);
+        return false;
+    }
+    return true;
+}
+
+// 通过内存映射载入二进制快照
+// 文件不存在、格式或参数不匹配、被截断时返回false，图保持为空
+bool Graph::load_binary(const std::string &filename)
+{
+    MappedFile file;
+    if (!file.open(filename))
+    {
+        return false;
+    }
+
+    std::string_view content = file.view();
+    GraphFileHeader header;
+    if (content.size() < sizeof(header))
+    {
+        return false;
+    }
+    std::memcpy(&header, content.data(), sizeof(header));
+    content.remove_prefix(sizeof(header));
+
+    // 校验格式以及生成快照时的权重参数
+    if (std::memcmp(header.magic, GRAPH_FILE_MAGIC, sizeof(header.magic)) != 0 ||
+        header.bpr_alpha != BPRConfig::alpha || header.bpr_beta != BPRConfig::beta ||
+        header.lane_capacity != BPRConfig::lane_capacity ||
+        header.time_factor != PathWeightConfig::time_factor ||
+        header.distance_factor != PathWeightConfig::distance_factor)
+    {
+        return false;
+    }
+
+    const size_t n = header.node_count;
+    const size_t m = header.edge_count;
+
+    bool complete = read_strings(content, node_names, n, header.name_bytes) &&
+                    read_array(content, offsets, n + 1) &&
+                    read_array(content, edge_sources, m) &&
+                    read_array(content, edge_targets, m) &&
+                    read_array(content, edge_lengths, m) &&
+                    read_array(content, edge_speed_limits, m) &&
+                    read_array(content, edge_lanes, m) &&
+                    read_array(content, edge_vehicles, m) &&
+                    read_array(content, edge_times, m) &&
+                    read_array(content, edge_balanced_scores, m) &&
+                    read_array(content, reverse_offsets, n + 1) &&
+                    read_array(content, reverse_edges, m) &&
+                    read_strings(content, road_ids, header.row_count, header.road_id_bytes) &&
+                    read_array(content, row_edges, static_cast<size_t>(header.row_count) * 2) &&
+                    check_structure();
+
+    if (!complete)
+    {
+        *this = Graph();
+        return false;
+    }
+
+    // 重建节点名驻留表和归一化范围（增量加载时需要）
+    node_ids.clear();
+    node_ids.reserve(n);
+    for (size_t v = 0; v < n; ++v)
+    {
+        node_ids.emplace(node_names[v], static_cast<uint32_t>(v));
+    }
+    weight_range = calculate_weight_range();
+
+    // 可达性索引不写入快照，载入后重新建立（线性时间）
+    if (SearchConfig::reachability)
+    {
+        build_reachability();
+    }
+
+    return true;
+}
+
+// 检查CSR结构是否自洽
+bool Graph::check_structure() const
+{
+    const size_t n = node_names.size();
+    const size_t m = edge_targets.size();
+    if (offsets.size() != n + 1 || reverse_offsets.size() != n + 1 || edge_sources.size() != m ||
+        reverse_edges.size() != m || offsets[0] != 0 || reverse_offsets[0] != 0 ||
+        offsets[n] != m || reverse_offsets[n] != m)
+    {
+        return false;
+    }
+
+    // 每个节点的出边区间单调，区间内的边都从该节点出发
+    for (size_t u = 0; u < n; ++u)
+    {
+        if (offsets[u] > offsets[u + 1] || reverse_offsets[u] > reverse_offsets[u + 1])
+        {
+            return false;
+        }
+        for (uint32_t e = offsets[u]; e < offsets[u + 1]; ++e)
+        {
+            if (edge_sources[e] != u || edge_targets[e] >= n)
+            {
+                return false;
+            }
+        }
+        for (uint32_t i = reverse_offsets[u]; i < reverse_offsets[u + 1]; ++i)
+        {
+            if (reverse_edges[i] >= m || edge_targets[reverse_edges[i]] != u)
+            {
+                return false;
+            }
+        }
+    }
+
+    for (uint32_t e : row_edges)
+    {
+        if (e != INVALID_ID && e >= m)
+        {
+            return false;
+        }
+    }
+
+    // 三种权重必须非负（限速或车道数为0的道路time和综合评分为无穷大），否则Dijkstra和基数堆的前提不成立
+    // （!(w >= 0) 同时排除了NaN）
+    for (const std::vector<double> *column : {&edge_lengths, &edge_times, &edge_balanced_scores})
+    {
+        if (column->size() != m)
+        {
+            return false;
+        }
+        for (double w : *column)
+        {
+            if (!(w >= 0))
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// 获取地点名对应的ID，不存在时分配新ID
+uint32_t Graph::intern_node(const std::string &name)
+{
+    auto it = node_ids.find(name);
+    if (it != node_ids.end())
+    {
+        return it->second;
+    }
+
+    uint32_t id = static_cast<uint32_t>(node_names.size());
+    node_ids.emplace(name, id);
+    node_names.push_back(name);
+    return id;
+}
+
+// 查找地点名对应的ID，不存在时返回INVALID_ID
+uint32_t Graph::find_node(const std::string &name) const
+{
+    auto it = node_ids.find(name);
+    return it == node_ids.end() ? INVALID_ID : it->second;
+}
+
+// 建立可达性索引
+void Graph::build_reachability()
+{
+    const size_t n = node_names.size();
+    node_components.assign(n, INVALID_ID);
+    component_reach.clear();
+    component_low.clear();
+    component_post.clear();
+    component_total = 0;
+    reach_words = 0;
+
+    // 迭代的Tarjan算法：call_stack模拟递归，保存节点和下一条待检查的出边
+    // 已编号但尚未归入分量的节点都在scc_stack中
+    std::vector<uint32_t> index(n, INVALID_ID);
+    std::vector<uint32_t> low(n, 0);
+    std::vector<uint32_t> scc_stack;
+    std::vector<std::pair<uint32_t, uint32_t>> call_stack;
+    uint32_t next_index = 0;
+
+    for (uint32_t root = 0; root < n; ++root)
+    {
+        if (index[root] != INVALID_ID)
+        {
+            continue;
+        }
+
+        index[root] = low[root] = next_index++;
+        scc_stack.push_back(root);
+        call_stack.emplace_back(root, offsets[root]);
+
+        while (!call_stack.empty())
+        {
+            uint32_t v = call_stack.back().first;
+            uint32_t e = call_stack.back().second;
+            if (e < offsets[v + 1])
+            {
+                call_stack.back().second++;
+                uint32_t w = edge_targets[e];
+                if (index[w] == INVALID_ID)
+                {
+                    index[w] = low[w] = next_index++;
+                    scc_stack.push_back(w);
+                    call_stack.emplace_back(w, offsets[w]);
+                }
+                else if (node_components[w] == INVALID_ID)
+                {
+                    low[v] = std::min(low[v], index[w]);
+                }
+                continue;
+            }
+
+            // v的出边都已检查：v是分量的根时弹出整个分量
+            if (low[v] == index[v])
+            {
+                uint32_t w;
+                do
+                {
+                    w = scc_stack.back();
+                    scc_stack.pop_back();
+                    node_components[w] = static_cast<uint32_t>(component_total);
+                } while (w != v);
+                component_total++;
+            }
+
+            call_stack.pop_back();
+            if (!call_stack.empty())
+            {
+                uint32_t parent = call_stack.back().first;
+                low[parent] = std::min(low[parent], low[v]);
+            }
+        }
+    }
+
+    // Tarjan按逆拓扑序（汇点先）得到分量，反转编号后跨分量的边总是从小编号指向大编号
+    for (uint32_t &component : node_components)
+    {
+        component = static_cast<uint32_t>(component_total - 1 - component);
+    }
+
+    // 压缩DAG的邻接表：按分量对跨分量的边做计数排序（同一对分量之间可能有重复的边）
+    std::vector<uint32_t> dag_offsets(component_total + 1, 0);
+    for (size_t e = 0; e < edge_targets.size(); ++e)
+    {
+        uint32_t c = node_components[edge_sources[e]];
+        if (c != node_components[edge_targets[e]])
+        {
+            dag_offsets[c + 1]++;
+        }
+    }
+    for (size_t c = 0; c < component_total; ++c)
+    {
+        dag_offsets[c + 1] += dag_offsets[c];
+    }
+    std::vector<uint32_t> dag_targets(dag_offsets.back());
+    std::vector<uint32_t> cursor(dag_offsets.begin(), dag_offsets.end() - 1);
+    for (size_t e = 0; e < edge_targets.size(); ++e)
+    {
+        uint32_t c = node_components[edge_sources[e]];
+        uint32_t d = node_components[edge_targets[e]];
+        if (c != d)
+        {
+            dag_targets[cursor[c]++] = d;
+        }
+    }
+
+    if (component_total <= REACH_CLOSURE_MAX_COMPONENTS)
+    {
+        // 按逆拓扑序计算传递闭包：每个分量可以到达自身以及所有后继分量能到达的分量
+        // 后继分量的编号都更大，处理到c时它们已经完成；同一后继只合并一次
+        reach_words = (component_total + 63) / 64;
+        component_reach.assign(component_total * reach_words, 0);
+        std::vector<uint32_t> merged_into(component_total, INVALID_ID);
+        for (size_t c = component_total; c-- > 0;)
+        {
+            uint64_t *row = component_reach.data() + c * reach_words;
+            row[c / 64] |= uint64_t(1) << (c % 64);
+
+            for (uint32_t i = dag_offsets[c]; i < dag_offsets[c + 1]; ++i)
+            {
+                uint32_t d = dag_targets[i];
+                if (merged_into[d] == c)
+                {
+                    continue;
+                }
+                merged_into[d] = static_cast<uint32_t>(c);
+
+                const uint64_t *successor = component_reach.data() + d * reach_words;
+                for (size_t word = 0; word < reach_words; ++word)
+                {
+                    row[word] |= successor[word];
+                }
+            }
+        }
+        return;
+    }
+
+    // 分量过多时用区间标号：在压缩DAG上做一次深度优先遍历，post为后序编号，low为所有子孙分量（含自身）中最小的后序编号
+    // DAG中没有环，遇到已访问的分量时它一定已经完成
+    component_low.assign(component_total, INVALID_ID);
+    component_post.assign(component_total, INVALID_ID);
+    std::vector<char> visited(component_total, 0);
+    std::vector<std::pair<uint32_t, uint32_t>> dfs_stack;
+    uint32_t next_post = 0;
+
+    for (uint32_t root = 0; root < component_total; ++root)
+    {
+        if (visited[root])
+        {
+            continue;
+        }
+        visited[root] = 1;
+        dfs_stack.emplace_back(root, dag_offsets[root]);
+
+        while (!dfs_stack.empty())
+        {
+            uint32_t c = dfs_stack.back().first;
+            uint32_t i = dfs_stack.back().second;
+            if (i < dag_offsets[c + 1])
+            {
+                dfs_stack.back().second++;
+                uint32_t d = dag_targets[i];
+                if (!visited[d])
+                {
+                    visited[d] = 1;
+                    dfs_stack.emplace_back(d, dag_offsets[d]);
+                }
+                else
+                {
+                    component_low[c] = std::min(component_low[c], component_low[d]);
+                }
+                continue;
+            }
+
+            component_post[c] = next_post++;
+            component_low[c] = std::min(component_low[c], component_post[c]);
+            dfs_stack.pop_back();
+            if (!dfs_stack.empty())
+            {
+                uint32_t parent = dfs_stack.back().first;
+                component_low[parent] = std::min(component_low[parent], component_low[c]);
+            }
+        }
+    }
+}
+
+// 分量from是否可能到达分量to
+bool Graph::component_reaches(uint32_t from, uint32_t to) const
+{
+    if (from == to)
+    {
+        return true;
+    }
+    if (from > to)
+    {
+        return false;
+    }
+    // 没有传递闭包时按区间标号判断：区间不包含一定不可达，包含时无法确定，视为可达
+    if (component_reach.empty())
+    {
+        return component_low[from] <= component_low[to] && component_post[to] <= component_post[from];
+    }
+    return (component_reach[from * reach_words + to / 64] >> (to % 64)) & 1;
+}
+
+// 判断target是否可能从source到达
+bool Graph::can_reach(uint32_t source, uint32_t target) const
+{
+    if (node_components.empty())
+    {
+        return true;
+    }
+    return component_reaches(node_components[source], node_components[target]);
+}
+
+// 计算图中所有边的权重范围（用于归一化）
+Graph::WeightRange Graph::calculate_weight_range() const
+{
+    Graph::WeightRange range;
+    range.time_min = std::numeric_limits<double>::infinity();
+    range.time_max = 0.0;
+    range.distance_min = std::numeric_limits<double>::infinity();
+    range.distance_max = 0.0;
+
+    // 扫描所有边
+    for (size_t e = 0; e < edge_times.size(); ++e)
+    {
+        // 更新时间范围（跳过不可通行的道路，否则time_max为无穷大，归一化结果全是NaN）
+        double time = edge_times[e];  // 使用预计算的通行时间
+        if (std::isfinite(time))
+        {
+            if (time < range.time_min)
+                range.time_min = time;
+            if (time > range.time_max)
+                range.time_max = time;
+        }
+
+        // 更新距离范围
+        double distance = edge_lengths[e];
+        if (distance < range.distance_min)
+            range.distance_min = distance;
+        if (distance > range.distance_max)
+            range.distance_max = distance;
+    }
+
+    return range;
+}
+
+// 获取各模式的权重列
+template <>
+const std::vector<double> &Graph::weights<WeightMode::TIME>() const
+{
+    return edge_times;
+}
+
+template <>
+const std::vector<double> &Graph::weights<WeightMode::DISTANCE>() const
+{
+    return edge_lengths;
+}
+
+template <>
+const std::vector<double> &Graph::weights<WeightMode::BALANCED>() const
+{
+    return edge_balanced_scores;
+}
+
+const std::vector<double> &Graph::weights(WeightMode mode) const
+{
+    switch (mode)
+    {
+    case WeightMode::DISTANCE:
+        return weights<WeightMode::DISTANCE>();
+    case WeightMode::BALANCED:
+        return weights<WeightMode::BALANCED>();
+    case WeightMode::TIME:
+    default:
+        return weights<WeightMode::TIME>();
+    }
+}
+
+// 查找最短路径
+PathResult Graph::find_shortest_path(const std::string &start, const std::string &end, WeightMode mode) const
+{
+    PathResult result;
+
+    // 检查起点是否存在于图中
+    uint32_t source = find_node(start);
+    if (source == INVALID_ID)
+    {
+        std::cerr << "Error: Start node '" << start << "' not found in graph." << std::endl;
+        return result;
+    }
+
+    // 起点就是终点，返回只包含起点的路径
+    if (end == start)
+    {
+        result.path.push_back(start);
+        return result;
+    }
+
+    // 终点不在图中，说明不可达
+    uint32_t target = find_node(end);
+    if (target == INVALID_ID)
+    {
+        return result;
+    }
+
+    return find_shortest_path(source, target, mode);
+}
+
+// 并行计算三种模式的最短路径
+MultiPath Graph::find_multi_path(const std::string &start, const std::string &end) const
+{
+    return find_multi_path(start, end, [this](uint32_t source, uint32_t target, WeightMode mode) {
+        return find_shortest_path(source, target, mode);
+    });
+}
+
+// 使用指定的搜索实现并行计算三种模式的最短路径
+MultiPath Graph::find_multi_path(const std::string &start, const std::string &end, const PathSearch &search) const
+{
+    MultiPath paths;
+
+    // 起终点只检查一次，避免三个线程重复输出同样的错误信息
+    uint32_t source = find_node(start);
+    if (source == INVALID_ID)
+    {
+        std::cerr << "Error: Start node '" << start << "' not found in graph." << std::endl;
+        return paths;
+    }
+
+    if (end == start)
+    {
+        paths.time_path.path.push_back(start);
+        paths.distance_path.path.push_back(start);
+        paths.balanced_path.path.push_back(start);
+        return paths;
+    }
+
+    // 终点不在图中或按可达性索引一定不可达，不必启动搜索
+    uint32_t target = find_node(end);
+    if (target == INVALID_ID || !can_reach(source, target))
+    {
+        return paths;
+    }
+
+    // TIME和DISTANCE在新线程上计算，BALANCED在当前线程上计算
+    // 每个线程只写自己的那一个PathResult，互不干扰
+    std::thread time_worker([&]() {
+        paths.time_path = search(source, target, WeightMode::TIME);
+    });
+    std::thread distance_worker([&]() {
+        paths.distance_path = search(source, target, WeightMode::DISTANCE);
+    });
+    paths.balanced_path = search(source, target, WeightMode::BALANCED);
+
+    time_worker.join();
+    distance_worker.join();
+
+    return paths;
+}
+
+// 按节点ID查找最短路径
+PathResult Graph::find_shortest_path(uint32_t source, uint32_t target, WeightMode mode) const
+{
+    // 可达性索引确定不可达时直接返回空路径
+    if (!can_reach(source, target))
+    {
+        return PathResult();
+    }
+
+    // 只在入口处根据优先队列、算法和模式分派一次，搜索内部不再有分支
+    switch (SearchConfig::queue)
+    {
+    case QueueType::BINARY_HEAP:
+        return find_shortest_path<BinaryHeapQueue>(source, target, mode);
+    case QueueType::RADIX_HEAP:
+        return find_shortest_path<RadixHeapQueue>(source, target, mode);
+    case QueueType::DARY_HEAP:
+    default:
+        return find_shortest_path<IndexedDaryHeap>(source, target, mode);
+    }
+}
+
+// 按算法和模式分派到特化的实现
+template <class Queue>
+PathResult Graph::find_shortest_path(uint32_t source, uint32_t target, WeightMode mode) const
+{
+    if (SearchConfig::algorithm == SearchAlgorithm::BIDIRECTIONAL)
+    {
+        switch (mode)
+        {
+        case WeightMode::DISTANCE:
+            return find_shortest_path_bidirectional<WeightMode::DISTANCE, Queue>(source, target);
+        case WeightMode::BALANCED:
+            return find_shortest_path_bidirectional<WeightMode::BALANCED, Queue>(source, target);
+        case WeightMode::TIME:
+        default:
+            return find_shortest_path_bidirectional<WeightMode::TIME, Queue>(source, target);
+        }
+    }
+
+    switch (mode)
+    {
+    case WeightMode::DISTANCE:
+        return find_shortest_path_impl<WeightMode::DISTANCE, Queue>(source, target);
+    case WeightMode::BALANCED:
+        return find_shortest_path_impl<WeightMode::BALANCED, Queue>(source, target);
+    case WeightMode::TIME:
+    default:
+        return find_shortest_path_impl<WeightMode::TIME, Queue>(source, target);
+    }
 }
 
-// 从CSV文件加载地图数据来构建图
-bool Graph::from_csv(const std::string &filename)
+// 按权重模式特化的Dijkstra
+template <WeightMode Mode, class Queue>
+PathResult Graph::find_shortest_path_impl(uint32_t source, uint32_t target) const
 {
-    std::ifstream file(filename);
-    if (!file.is_open())
+    // 本模式使用的权重列
+    const double *weight = weights<Mode>().data();
+    const uint32_t *targets = edge_targets.data();
+
+    // 优先队列: <距离, 节点ID>
+    Queue pq(node_names.size());
+
+    // 从起点到图中每个节点的最短距离
+    std::vector<double> distances(node_names.size(), std::numeric_limits<double>::infinity());
+
+    // 最短路径树中每个节点的入边（边ID），用于最后回溯路径
+    std::vector<uint32_t> predecessors(node_names.size(), INVALID_ID);
+
+    // 可达性剪枝：不能到达终点所在分量的节点不可能在路径上，不放入队列（不影响得到的路径）
+    const bool prune = !node_components.empty();
+    const uint32_t target_component = prune ? node_components[target] : 0;
+
+    // 起点到自身的距离为0
+    distances[source] = 0;
+    pq.push(source, 0.0);
+    size_t settled = 0;
+
+    // Dijkstra
+    while (!pq.empty())
     {
-        std::cerr << "Error: Could not open file " << filename << std::endl;
-        return false;
+        auto [current_dist, current_node] = pq.pop();
+
+        // 如果队列中取出的距离比已知的最短距离要长，说明是旧的、已作废的记录，跳过
+        if (current_dist > distances[current_node])
+        {
+            continue;
+        }
+        settled++;
+
+        // 如果当前节点就是终点，则路径已找到，可以提前退出循环
+        if (current_node == target)
+        {
+            break;
+        }
+
+        // 遍历当前节点的所有出边（"松弛"操作）
+        for (uint32_t e = offsets[current_node]; e < offsets[current_node + 1]; ++e)
+        {
+            uint32_t neighbor = targets[e];
+            double new_dist = current_dist + weight[e];
+
+            if (new_dist < distances[neighbor])
+            {
+                if (prune && !component_reaches(node_components[neighbor], target_component))
+                {
+                    continue;
+                }
+
+                // 更新最短距离和前驱边
+                distances[neighbor] = new_dist;
+                predecessors[neighbor] = e;
+
+                // 将更新后的邻居放入优先队列（已在队列中时降低其距离）
+                pq.push(neighbor, new_dist);
+            }
+        }
     }
 
-    // 清空旧的邻接表，以便加载新地图
-    adj_list.clear();
+    // 终点没有前驱，说明不可达
+    if (predecessors[target] == INVALID_ID)
+    {
+        PathResult unreachable; // 返回空路径（终点不可达）
+        unreachable.settled_nodes = settled;
+        return unreachable;
+    }
 
-    std::string line;
+    PathResult result = build_path_result(source, target, predecessors);
+    result.settled_nodes = settled;
+    return result;
+}
 
-    // 读取并解析表头
-    if (!std::getline(file, line))
+// 单源最短距离（不提前停止的Dijkstra）
+std::vector<double> Graph::shortest_distances(uint32_t source, WeightMode mode, bool reverse) const
+{
+    switch (SearchConfig::queue)
     {
-        std::cerr << "Error: Could not read header line from " << filename << std::endl;
-        return false;
+    case QueueType::BINARY_HEAP:
+        return shortest_distances_impl<BinaryHeapQueue>(source, mode, reverse);
+    case QueueType::RADIX_HEAP:
+        return shortest_distances_impl<RadixHeapQueue>(source, mode, reverse);
+    case QueueType::DARY_HEAP:
+    default:
+        return shortest_distances_impl<IndexedDaryHeap>(source, mode, reverse);
     }
+}
+
+template <class Queue>
+std::vector<double> Graph::shortest_distances_impl(uint32_t source, WeightMode mode, bool reverse) const
+{
+    const double *weight = weights(mode).data();
+    std::vector<double> distances(node_names.size(), std::numeric_limits<double>::infinity());
+
+    Queue pq(node_names.size());
 
-    std::stringstream header_ss(line);
-    std::string field;
-    std::vector<std::string> headers;
-    while (std::getline(header_ss, field, ','))
+    distances[source] = 0;
+    pq.push(source, 0.0);
+
+    while (!pq.empty())
     {
-        // 移除可能的回车符
-        if (!field.empty() && field.back() == '\r')
+        auto [current_dist, current_node] = pq.pop();
+
+        if (current_dist > distances[current_node])
+        {
+            continue;
+        }
+
+        if (!reverse)
+        {
+            for (uint32_t e = offsets[current_node]; e < offsets[current_node + 1]; ++e)
+            {
+                uint32_t neighbor = edge_targets[e];
+                double new_dist = current_dist + weight[e];
+                if (new_dist < distances[neighbor])
+                {
+                    distances[neighbor] = new_dist;
+                    pq.push(neighbor, new_dist);
+                }
+            }
+        }
+        else
         {
-            field.pop_back();
+            for (uint32_t i = reverse_offsets[current_node]; i < reverse_offsets[current_node + 1]; ++i)
+            {
+                uint32_t e = reverse_edges[i];
+                uint32_t neighbor = edge_sources[e];
+                double new_dist = current_dist + weight[e];
+                if (new_dist < distances[neighbor])
+                {
+                    distances[neighbor] = new_dist;
+                    pq.push(neighbor, new_dist);
+                }
+            }
         }
-        headers.push_back(field);
     }
 
-    // 动态确定列索引
-    int start_node_idx = -1, end_node_idx = -1, direction_idx = -1,
-        length_idx = -1, speed_limit_idx = -1, lanes_idx = -1, vehicles_idx = -1;
+    return distances;
+}
+
+// 多对多距离矩阵
+DistanceMatrix Graph::distance_matrix(const std::vector<std::string> &sources, const std::vector<std::string> &targets,
+                                      WeightMode mode) const
+{
+    DistanceMatrix matrix;
+    matrix.sources = sources;
+    matrix.targets = targets;
+    matrix.times.assign(sources.size() * targets.size(), std::numeric_limits<double>::infinity());
+    matrix.distances.assign(sources.size() * targets.size(), std::numeric_limits<double>::infinity());
 
-    for (int i = 0; i < headers.size(); ++i)
+    for (const std::vector<std::string> *names : {&sources, &targets})
     {
-        if (headers[i] == "起始地点") start_node_idx = i;
-        else if (headers[i] == "目标地点") end_node_idx = i;
-        else if (headers[i] == "道路方向") direction_idx = i;
-        else if (headers[i] == "道路长度(米)") length_idx = i;
-        else if (headers[i] == "道路限速(km/h)") speed_limit_idx = i;
-        else if (headers[i] == "车道数") lanes_idx = i;
-        else if (headers[i] == "现有车辆数") vehicles_idx = i;
+        for (const std::string &name : *names)
+        {
+            if (find_node(name) == INVALID_ID)
+            {
+                std::cerr << "Warning: Node '" << name << "' not found in graph, treated as unreachable." << std::endl;
+            }
+        }
     }
 
-    // 检查是否所有必需的列都已找到
-    if (start_node_idx == -1 || end_node_idx == -1 || direction_idx == -1 ||
-        length_idx == -1 || speed_limit_idx == -1 || lanes_idx == -1 || vehicles_idx == -1)
+    switch (SearchConfig::queue)
     {
-        std::cerr << "Error: CSV file " << filename << " is missing one or more required columns." << std::endl;
-        return false;
+    case QueueType::BINARY_HEAP:
+        distance_matrix<BinaryHeapQueue>(matrix, mode);
+        break;
+    case QueueType::RADIX_HEAP:
+        distance_matrix<RadixHeapQueue>(matrix, mode);
+        break;
+    case QueueType::DARY_HEAP:
+    default:
+        distance_matrix<IndexedDaryHeap>(matrix, mode);
+        break;
     }
+    return matrix;
+}
 
-    // 逐行读取文件内容
-    int line_number = 1; // 表头已读取
-    while (std::getline(file, line))
+template <class Queue>
+void Graph::distance_matrix(DistanceMatrix &matrix, WeightMode mode) const
+{
+    switch (mode)
     {
-        line_number++;
-        std::stringstream ss(line);
-        std::vector<std::string> fields;
+    case WeightMode::DISTANCE:
+        distance_matrix_impl<WeightMode::DISTANCE, Queue>(matrix);
+        break;
+    case WeightMode::BALANCED:
+        distance_matrix_impl<WeightMode::BALANCED, Queue>(matrix);
+        break;
+    case WeightMode::TIME:
+    default:
+        distance_matrix_impl<WeightMode::TIME, Queue>(matrix);
+        break;
+    }
+}
+
+// 按权重模式特化的距离矩阵
+// 每个起点一次单源Dijkstra，松弛时沿树累加路径的时间和距离；所有（不同的）终点都出队后停止
+template <WeightMode Mode, class Queue>
+void Graph::distance_matrix_impl(DistanceMatrix &matrix) const
+{
+    const double *weight = weights<Mode>().data();
+    const size_t n = node_names.size();
+    const size_t column_count = matrix.targets.size();
 
-        while (std::getline(ss, field, ','))
+    // 终点节点 -> 是否为终点，并记下不同的终点
+    std::vector<char> is_target(n, 0);
+    std::vector<uint32_t> distinct_targets;
+    for (const std::string &name : matrix.targets)
+    {
+        uint32_t id = find_node(name);
+        if (id != INVALID_ID && !is_target[id])
         {
-            // 移除可能的回车符
-            if (!field.empty() && field.back() == '\r')
-            {
-                field.pop_back();
-            }
-            fields.push_back(field);
+            is_target[id] = 1;
+            distinct_targets.push_back(id);
         }
+    }
 
-        if (fields.size() < headers.size())
+    auto search = [&](size_t row) {
+        uint32_t source = find_node(matrix.sources[row]);
+        if (source == INVALID_ID)
         {
-            // 跳过格式不正确的行
-            continue;
+            return;
         }
 
-        std::string start_node = fields[start_node_idx];
-        std::string end_node = fields[end_node_idx];
-        std::string direction = fields[direction_idx];
+        std::vector<double> distances(n, std::numeric_limits<double>::infinity());
+        std::vector<double> path_times(n, 0.0);
+        std::vector<double> path_lengths(n, 0.0);
+        Queue pq(n);
 
-        try
+        // 按可达性索引一定不可达的终点不必等待
+        size_t remaining = 0;
+        for (uint32_t target : distinct_targets)
         {
-            double length = std::stod(fields[length_idx]);
-            double speed_limit = std::stod(fields[speed_limit_idx]);
-            int lanes = std::stoi(fields[lanes_idx]);
-            int current_vehicles = std::stoi(fields[vehicles_idx]);
+            if (can_reach(source, target))
+            {
+                remaining++;
+            }
+        }
+
+        distances[source] = 0;
+        pq.push(source, 0.0);
 
-            // 使用Edge的构造函数创建边
-            adj_list[start_node].emplace_back(end_node, length, speed_limit, lanes, current_vehicles);
+        while (!pq.empty() && remaining > 0)
+        {
+            auto [current_dist, current_node] = pq.pop();
+            if (current_dist > distances[current_node])
+            {
+                continue;
+            }
+            if (is_target[current_node])
+            {
+                remaining--;
+            }
 
-            // 如果是双向路，则添加反向的边
-            if (direction == "双向")
+            for (uint32_t e = offsets[current_node]; e < offsets[current_node + 1]; ++e)
             {
-                adj_list[end_node].emplace_back(start_node, length, speed_limit, lanes, current_vehicles);
+                uint32_t neighbor = edge_targets[e];
+                double new_dist = current_dist + weight[e];
+                if (new_dist < distances[neighbor])
+                {
+                    distances[neighbor] = new_dist;
+                    path_times[neighbor] = path_times[current_node] + edge_times[e];
+                    path_lengths[neighbor] = path_lengths[current_node] + edge_lengths[e];
+                    pq.push(neighbor, new_dist);
+                }
             }
         }
-        catch (const std::invalid_argument &e)
+
+        // 停止时所有可达的终点都已出队，它们的距离和累加值是最终结果
+        for (size_t column = 0; column < column_count; ++column)
         {
-            std::cerr << "Warning: Invalid data format at line " << line_number << " in " << filename << ", skipping this line." << std::endl;
-            continue;
+            uint32_t target = find_node(matrix.targets[column]);
+            if (target != INVALID_ID && distances[target] != std::numeric_limits<double>::infinity())
+            {
+                matrix.times[row * column_count + column] = path_times[target];
+                matrix.distances[row * column_count + column] = path_lengths[target];
+            }
         }
-        catch (const std::out_of_range &e)
+    };
+
+    // 每个起点一个任务，各任务只写矩阵中属于自己的一行
+    ThreadPool pool(std::min<size_t>(std::max<size_t>(matrix.sources.size(), 1), std::thread::hardware_concurrency()));
+    for (size_t row = 0; row < matrix.sources.size(); ++row)
+    {
+        pool.submit([&search, row]() { search(row); });
+    }
+    pool.wait();
+}
+
+// 一对多：同一起点的多个终点共用一次搜索
+std::vector<MultiPath> Graph::find_multi_paths(const std::string &start, const std::vector<std::string> &ends) const
+{
+    std::vector<MultiPath> paths(ends.size());
+
+    uint32_t source = find_node(start);
+    if (source == INVALID_ID)
+    {
+        std::cerr << "Error: Start node '" << start << "' not found in graph." << std::endl;
+        return paths;
+    }
+
+    // 不存在的终点记为INVALID_ID，视为不可达
+    std::vector<uint32_t> targets(ends.size());
+    for (size_t i = 0; i < ends.size(); ++i)
+    {
+        targets[i] = find_node(ends[i]);
+    }
+
+    std::vector<PathResult> results;
+    for (WeightMode mode : {WeightMode::TIME, WeightMode::DISTANCE, WeightMode::BALANCED})
+    {
+        switch (SearchConfig::queue)
         {
-            std::cerr << "Warning: Data out of range at line " << line_number << " in " << filename << ", skipping this line." << std::endl;
-            continue;
+        case QueueType::BINARY_HEAP:
+            results = find_paths_from<BinaryHeapQueue>(source, targets, mode);
+            break;
+        case QueueType::RADIX_HEAP:
+            results = find_paths_from<RadixHeapQueue>(source, targets, mode);
+            break;
+        case QueueType::DARY_HEAP:
+        default:
+            results = find_paths_from<IndexedDaryHeap>(source, targets, mode);
+            break;
+        }
+
+        for (size_t i = 0; i < ends.size(); ++i)
+        {
+            PathResult &slot = mode == WeightMode::TIME       ? paths[i].time_path
+                               : mode == WeightMode::DISTANCE ? paths[i].distance_path
+                                                              : paths[i].balanced_path;
+            slot = std::move(results[i]);
         }
     }
 
-    file.close();
+    return paths;
+}
 
-    // 检查是否成功加载了边
-    if (adj_list.empty())
+template <class Queue>
+std::vector<PathResult> Graph::find_paths_from(uint32_t source, const std::vector<uint32_t> &targets,
+                                               WeightMode mode) const
+{
+    switch (mode)
     {
-        std::cerr << "Warning: No valid edges loaded from " << filename << ". The graph is empty." << std::endl;
-        return true;
+    case WeightMode::DISTANCE:
+        return find_paths_from_impl<WeightMode::DISTANCE, Queue>(source, targets);
+    case WeightMode::BALANCED:
+        return find_paths_from_impl<WeightMode::BALANCED, Queue>(source, targets);
+    case WeightMode::TIME:
+    default:
+        return find_paths_from_impl<WeightMode::TIME, Queue>(source, targets);
     }
+}
 
-    // 计算所有边的time字段
-    for (auto &node_pair : adj_list)
+// 按权重模式特化的一对多Dijkstra：记录前驱边，所有（不同的）终点都出队后停止，再逐个回溯路径
+template <WeightMode Mode, class Queue>
+std::vector<PathResult> Graph::find_paths_from_impl(uint32_t source, const std::vector<uint32_t> &targets) const
+{
+    const double *weight = weights<Mode>().data();
+    const size_t n = node_names.size();
+
+    // 一定不可达的终点不计入remaining，其余终点都出队后即可停止
+    std::vector<char> is_target(n, 0);
+    size_t remaining = 0;
+    for (uint32_t target : targets)
     {
-        for (Edge &edge : node_pair.second)
+        if (target != INVALID_ID && !is_target[target] && can_reach(source, target))
         {
-            edge.time = calculate_travel_time(edge.length, edge.speed_limit, edge.lanes, edge.current_vehicles);
+            is_target[target] = 1;
+            remaining++;
         }
     }
 
-    // 计算时间和距离的范围用于归一化
-    WeightRange range = calculate_weight_range();
+    std::vector<double> distances(n, std::numeric_limits<double>::infinity());
+    std::vector<uint32_t> predecessors(n, INVALID_ID);
+    Queue pq(n);
 
-    // 计算balanced_score
-    for (auto &node_pair : adj_list)
+    distances[source] = 0;
+    pq.push(source, 0.0);
+    size_t settled = 0;
+
+    while (!pq.empty() && remaining > 0)
     {
-        for (Edge &edge : node_pair.second)
+        auto [current_dist, current_node] = pq.pop();
+        if (current_dist > distances[current_node])
         {
-            double normalized_time = 0.0;
-            double normalized_distance = 0.0;
-
-            // 归一化
-            if (range.time_max > range.time_min)
-            {
-                normalized_time = (edge.time - range.time_min) / (range.time_max - range.time_min);
-            }
+            continue;
+        }
+        settled++;
+        if (is_target[current_node])
+        {
+            remaining--;
+        }
 
-            if (range.distance_max > range.distance_min)
+        for (uint32_t e = offsets[current_node]; e < offsets[current_node + 1]; ++e)
+        {
+            uint32_t neighbor = edge_targets[e];
+            double new_dist = current_dist + weight[e];
+            if (new_dist < distances[neighbor])
             {
-                normalized_distance = (edge.length - range.distance_min) / (range.distance_max - range.distance_min);
+                distances[neighbor] = new_dist;
+                predecessors[neighbor] = e;
+                pq.push(neighbor, new_dist);
             }
+        }
+    }
 
-            // 加权平均
-            edge.balanced_score = PathWeightConfig::time_factor * normalized_time +
-                                  PathWeightConfig::distance_factor * normalized_distance;
+    std::vector<PathResult> results(targets.size());
+    for (size_t i = 0; i < targets.size(); ++i)
+    {
+        uint32_t target = targets[i];
+        if (target == source)
+        {
+            results[i].path.push_back(node_names[source]);
+        }
+        else if (target != INVALID_ID && predecessors[target] != INVALID_ID)
+        {
+            results[i] = build_path_result(source, target, predecessors);
         }
+        results[i].settled_nodes = settled;
     }
+    return results;
+}
 
-    return true;
+// 最短路径树（不提前停止的Dijkstra）
+ShortestPathTree Graph::shortest_path_tree(uint32_t source, WeightMode mode) const
+{
+    switch (SearchConfig::queue)
+    {
+    case QueueType::BINARY_HEAP:
+        return shortest_path_tree<BinaryHeapQueue>(source, mode);
+    case QueueType::RADIX_HEAP:
+        return shortest_path_tree<RadixHeapQueue>(source, mode);
+    case QueueType::DARY_HEAP:
+    default:
+        return shortest_path_tree<IndexedDaryHeap>(source, mode);
+    }
 }
 
-// 计算图中所有边的权重范围（用于归一化）
-Graph::WeightRange Graph::calculate_weight_range() const
+template <class Queue>
+ShortestPathTree Graph::shortest_path_tree(uint32_t source, WeightMode mode) const
 {
-    Graph::WeightRange range;
-    range.time_min = std::numeric_limits<double>::infinity();
-    range.time_max = 0.0;
-    range.distance_min = std::numeric_limits<double>::infinity();
-    range.distance_max = 0.0;
+    ShortestPathTree tree;
+    tree.source = source;
+    tree.mode = mode;
+    tree.edge_count = edge_targets.size();
 
-    // 扫描所有边
-    for (const auto &pair : adj_list)
+    switch (mode)
     {
-        for (const Edge &edge : pair.second)
+    case WeightMode::DISTANCE:
+        shortest_path_tree_impl<WeightMode::DISTANCE, Queue>(tree);
+        break;
+    case WeightMode::BALANCED:
+        shortest_path_tree_impl<WeightMode::BALANCED, Queue>(tree);
+        break;
+    case WeightMode::TIME:
+    default:
+        shortest_path_tree_impl<WeightMode::TIME, Queue>(tree);
+        break;
+    }
+    return tree;
+}
+
+// 按权重模式特化的最短路径树：松弛顺序与点对点Dijkstra相同，已确定节点的入边不会再改变，
+// 因此回溯得到的路径与点对点搜索在目标出队时得到的路径一致
+template <WeightMode Mode, class Queue>
+void Graph::shortest_path_tree_impl(ShortestPathTree &tree) const
+{
+    const double *weight = weights<Mode>().data();
+    const size_t n = node_names.size();
+
+    std::vector<double> distances(n, std::numeric_limits<double>::infinity());
+    tree.predecessors.assign(n, INVALID_ID);
+    Queue pq(n);
+
+    distances[tree.source] = 0;
+    pq.push(tree.source, 0.0);
+    size_t settled = 0;
+
+    while (!pq.empty())
+    {
+        auto [current_dist, current_node] = pq.pop();
+        if (current_dist > distances[current_node])
         {
-            // 更新时间范围
-            double time = edge.time;  // 使用预计算的通行时间
-            if (time < range.time_min)
-                range.time_min = time;
-            if (time > range.time_max)
-                range.time_max = time;
+            continue;
+        }
+        settled++;
 
-            // 更新距离范围
-            double distance = edge.length;
-            if (distance < range.distance_min)
-                range.distance_min = distance;
-            if (distance > range.distance_max)
-                range.distance_max = distance;
+        for (uint32_t e = offsets[current_node]; e < offsets[current_node + 1]; ++e)
+        {
+            uint32_t neighbor = edge_targets[e];
+            double new_dist = current_dist + weight[e];
+            if (new_dist < distances[neighbor])
+            {
+                distances[neighbor] = new_dist;
+                tree.predecessors[neighbor] = e;
+                pq.push(neighbor, new_dist);
+            }
         }
     }
-
-    return range;
+    tree.settled_nodes = settled;
 }
 
-// 查找最短路径
-PathResult Graph::find_shortest_path(const std::string &start, const std::string &end, WeightMode mode)
+PathResult Graph::path_from_tree(const ShortestPathTree &tree, uint32_t target) const
 {
     PathResult result;
-
-    // 检查起点是否存在于图中（起点必须有出边）
-    if (adj_list.find(start) == adj_list.end())
+    if (target == tree.source)
     {
-        std::cerr << "Error: Start node '" << start << "' not found in graph." << std::endl;
-        return result;
+        result.path.push_back(node_names[target]);
     }
+    else if (target < tree.predecessors.size() && tree.predecessors[target] != INVALID_ID)
+    {
+        result = build_path_result(tree.source, target, tree.predecessors);
+    }
+    return result;
+}
 
-    // 注意：终点不需要检查，因为它可能只作为边的目标节点出现（没有出边）
-
-    // 定义优先队列的元素类型: <距离, 节点名>
-    using QElement = std::pair<double, std::string>;
-    std::priority_queue<QElement, std::vector<QElement>, std::greater<QElement>> pq;
+// 按权重模式特化的双向Dijkstra
+// 正向在原图上从source搜索，反向在反向图上从target搜索，每轮扩展队首距离较小的一侧
+// 停止条件：两侧队首距离之和不小于当前已知的最短路径长度best，
+// 此时任何尚未发现的路径都至少为 top_forward + top_backward >= best，best即为最短路径
+template <WeightMode Mode, class Queue>
+PathResult Graph::find_shortest_path_bidirectional(uint32_t source, uint32_t target) const
+{
+    const double *weight = weights<Mode>().data();
+    const double infinity = std::numeric_limits<double>::infinity();
 
-    // 从起点到图中每个节点的最短距离
-    std::unordered_map<std::string, double> distances;
+    // 下标0为正向搜索，下标1为反向搜索
+    Queue pq[2] = {Queue(node_names.size()), Queue(node_names.size())};
+    std::vector<double> distances[2] = {
+        std::vector<double>(node_names.size(), infinity),
+        std::vector<double>(node_names.size(), infinity)};
 
-    // 最短路径树中每个节点的前驱节点，用于最后回溯路径
-    std::unordered_map<std::string, std::string> predecessors;
+    // 正向记录每个节点的入边，反向记录每个节点通往target方向的出边
+    std::vector<uint32_t> predecessors[2] = {
+        std::vector<uint32_t>(node_names.size(), INVALID_ID),
+        std::vector<uint32_t>(node_names.size(), INVALID_ID)};
 
-    // 初始化
-    for (const auto &pair : adj_list)
-    {
-        distances[pair.first] = std::numeric_limits<double>::infinity();
-    }
+    distances[0][source] = 0;
+    distances[1][target] = 0;
+    pq[0].push(source, 0.0);
+    pq[1].push(target, 0.0);
 
-    // 起点到自身的距离为0
-    distances[start] = 0;
-    pq.push({0.0, start});
+    double best = infinity;          // 当前已知的最短路径长度
+    uint32_t meeting = INVALID_ID;   // 最短路径上两侧搜索的交汇节点
+    size_t settled = 0;
 
-    // Dijkstra
-    while (!pq.empty())
+    while (!pq[0].empty() && !pq[1].empty())
     {
-        double current_dist = pq.top().first;
-        std::string current_node = pq.top().second;
-        pq.pop();
-
-        // 如果当前节点就是终点，则路径已找到，可以提前退出循环
-        if (current_node == end)
+        double top_forward = pq[0].top_key();
+        double top_backward = pq[1].top_key();
+        if (top_forward + top_backward >= best)
         {
             break;
         }
 
-        // 如果队列中取出的距离比已知的最短距离要长，说明是旧的、已作废的记录，跳过
-        if (current_dist > distances[current_node])
+        // 选择队首距离较小的一侧进行扩展
+        int side = (top_forward <= top_backward) ? 0 : 1;
+        auto [current_dist, current_node] = pq[side].pop();
+
+        // 跳过作废的记录
+        if (current_dist > distances[side][current_node])
         {
             continue;
         }
+        settled++;
 
-        // 遍历当前节点的所有邻居（"松弛"操作）
-        if (adj_list.count(current_node))
+        const std::vector<double> &other = distances[1 - side];
+
+        if (side == 0)
         {
-            for (const Edge &edge : adj_list.at(current_node))
+            // 正向：松弛出边
+            for (uint32_t e = offsets[current_node]; e < offsets[current_node + 1]; ++e)
             {
-                std::string neighbor = edge.destination;
-                // 根据模式获取边的权重
-                double edge_weight = edge.get_weight(mode);
-                double new_dist = current_dist + edge_weight;
+                uint32_t neighbor = edge_targets[e];
+                double new_dist = current_dist + weight[e];
 
-                // 如果邻居节点还没有在distances中，初始化为无穷大
-                if (distances.find(neighbor) == distances.end())
+                if (new_dist < distances[0][neighbor])
                 {
-                    distances[neighbor] = std::numeric_limits<double>::infinity();
+                    distances[0][neighbor] = new_dist;
+                    predecessors[0][neighbor] = e;
+                    pq[0].push(neighbor, new_dist);
                 }
 
-                if (new_dist < distances[neighbor])
+                // 邻居已被反向搜索到达，尝试更新最短路径
+                if (new_dist + other[neighbor] < best && new_dist <= distances[0][neighbor])
                 {
-                    // 更新最短距离和前驱节点
-                    distances[neighbor] = new_dist;
-                    predecessors[neighbor] = current_node;
+                    best = new_dist + other[neighbor];
+                    meeting = neighbor;
+                }
+            }
+        }
+        else
+        {
+            // 反向：沿入边松弛
+            for (uint32_t i = reverse_offsets[current_node]; i < reverse_offsets[current_node + 1]; ++i)
+            {
+                uint32_t e = reverse_edges[i];
+                uint32_t neighbor = edge_sources[e];
+                double new_dist = current_dist + weight[e];
+
+                if (new_dist < distances[1][neighbor])
+                {
+                    distances[1][neighbor] = new_dist;
+                    predecessors[1][neighbor] = e;
+                    pq[1].push(neighbor, new_dist);
+                }
 
-                    // 将更新后的邻居放入优先队列
-                    pq.push({new_dist, neighbor});
+                if (new_dist + other[neighbor] < best && new_dist <= distances[1][neighbor])
+                {
+                    best = new_dist + other[neighbor];
+                    meeting = neighbor;
                 }
             }
         }
     }
 
-    // 路径回溯
-    std::string current = end;
+    // 两侧搜索没有交汇，说明不可达
+    if (meeting == INVALID_ID)
+    {
+        PathResult unreachable;
+        unreachable.settled_nodes = settled;
+        return unreachable;
+    }
 
-    // 检查是否找到路径：
-    // 1. 如果终点就是起点，返回只包含起点的路径
-    // 2. 如果终点不是起点，但终点没有前驱节点，说明不可达
-    if (end == start)
+    // 前半段（source -> meeting）沿正向前驱回溯，后半段（meeting -> target）沿反向前驱前进
+    std::vector<uint32_t> edge_path;
+    uint32_t current = meeting;
+    while (current != source)
     {
-        result.path.push_back(start);
-        return result;
+        uint32_t e = predecessors[0][current];
+        edge_path.push_back(e);
+        current = edge_sources[e];
     }
+    std::reverse(edge_path.begin(), edge_path.end());
 
-    if (predecessors.find(end) == predecessors.end())
+    current = meeting;
+    while (current != target)
     {
-        return result; // 返回空路径（终点不可达）
+        uint32_t e = predecessors[1][current];
+        edge_path.push_back(e);
+        current = edge_targets[e];
     }
 
-    while (predecessors.count(current))
+    PathResult result = build_path_result(source, edge_path);
+    result.settled_nodes = settled;
+    return result;
+}
+
+// 沿前驱边回溯路径
+PathResult Graph::build_path_result(uint32_t source, uint32_t target,
+                                    const std::vector<uint32_t> &predecessors) const
+{
+    // 回溯前驱边，得到从target到source的逆序边序列
+    std::vector<uint32_t> edge_path;
+    uint32_t current = target;
+    while (current != source)
     {
-        result.path.push_back(current);
-        current = predecessors[current];
+        uint32_t e = predecessors[current];
+        edge_path.push_back(e);
+        current = edge_sources[e];
     }
 
-    // 最后加入起点
-    result.path.push_back(start);
+    std::reverse(edge_path.begin(), edge_path.end());
+    return build_path_result(source, edge_path);
+}
 
-    // 翻转路径
-    std::reverse(result.path.begin(), result.path.end());
+// 根据从source出发的边序列构造路径，并把节点ID映射回地点名
+PathResult Graph::build_path_result(uint32_t source, const std::vector<uint32_t> &edge_path) const
+{
+    PathResult result;
+    result.path.reserve(edge_path.size() + 1);
+    result.path.push_back(node_names[source]);
 
-    // 计算时间和距离（总是计算两个指标）
-    result.time = calculate_path_cost(result.path, WeightMode::TIME);
-    result.distance = calculate_path_cost(result.path, WeightMode::DISTANCE);
+    // 同时累加时间和距离（总是计算两个指标）
+    for (uint32_t e : edge_path)
+    {
+        result.time += edge_times[e];
+        result.distance += edge_lengths[e];
+        result.path.push_back(node_names[edge_targets[e]]);
+    }
 
     return result;
 }
 
+// 图占用内存的估计值
+size_t Graph::memory_usage() const
+{
+    auto array_bytes = [](const auto &values) {
+        return values.capacity() * sizeof(values[0]);
+    };
+
+    // 超出短字符串容量的字符串在堆上另外分配
+    const size_t inline_capacity = std::string().capacity();
+    auto heap_bytes = [inline_capacity](const std::string &text) {
+        return text.capacity() > inline_capacity ? text.capacity() + 1 : 0;
+    };
+
+    size_t bytes = sizeof(Graph);
+    bytes += array_bytes(offsets) + array_bytes(edge_sources) + array_bytes(edge_targets);
+    bytes += array_bytes(edge_lengths) + array_bytes(edge_speed_limits) + array_bytes(edge_lanes);
+    bytes += array_bytes(edge_vehicles) + array_bytes(edge_times) + array_bytes(edge_balanced_scores);
+    bytes += array_bytes(reverse_offsets) + array_bytes(reverse_edges) + array_bytes(row_edges);
+    bytes += array_bytes(node_components) + array_bytes(component_reach);
+    bytes += array_bytes(component_low) + array_bytes(component_post);
+    bytes += array_bytes(node_names) + array_bytes(road_ids);
+    for (const std::vector<std::string> *names : {&node_names, &road_ids})
+    {
+        for (const std::string &name : *names)
+        {
+            bytes += heap_bytes(name);
+        }
+    }
+
+    // 名字索引：每个元素一个链表节点（后继指针和键值对），加上桶数组
+    for (const auto &entry : node_ids)
+    {
+        bytes += sizeof(void *) + sizeof(entry) + heap_bytes(entry.first);
+    }
+    bytes += node_ids.bucket_count() * sizeof(void *);
+    return bytes;
+}
+
 // 计算给定路径的总代价
-double Graph::calculate_path_cost(const std::vector<std::string> &path, WeightMode mode)
+double Graph::calculate_path_cost(const std::vector<std::string> &path, WeightMode mode) const
 {
     if (path.size() < 2)
     {
@@ -344,13 +2003,15 @@ double Graph::calculate_path_cost(const std::vector<std::string> &path, WeightMo
 
         // 查找边
         bool edge_found = false;
-        if (adj_list.count(from))
+        uint32_t from_id = find_node(from);
+        uint32_t to_id = find_node(to);
+        if (from_id != INVALID_ID && to_id != INVALID_ID)
         {
-            for (const Edge &edge : adj_list.at(from))
+            for (uint32_t e = offsets[from_id]; e < offsets[from_id + 1]; ++e)
             {
-                if (edge.destination == to)
+                if (edge_targets[e] == to_id)
                 {
-                    total_cost += edge.get_weight(mode);
+                    total_cost += weights(mode)[e];
                     edge_found = true;
                     break;
                 }
@@ -1,9 +1,12 @@
 #ifndef GRAPH_H
 #define GRAPH_H
 
+#include <cstdint>
+#include <limits>
 #include <string>
 #include <vector>
 #include <unordered_map>
+#include <functional>
 #include "Edge.h"
 #include "config.h"
 
@@ -13,8 +16,9 @@ struct PathResult
     std::vector<std::string> path;  // 路径节点列表
     double time;                     // 总时间（秒）
     double distance;                 // 总距离（米）
+    size_t settled_nodes;            // 搜索中确定最短距离的节点数（仅用于统计，不写入缓存）
 
-    PathResult() : time(0), distance(0) {}
+    PathResult() : time(0), distance(0), settled_nodes(0) {}
 };
 
 // 多路径结构体（存储三种路径）
@@ -28,6 +32,38 @@ struct MultiPath
     MultiPath() {}
 };
 
+// 同一路网两个快照之间的差异（Graph::compare_snapshot）
+struct SnapshotDelta
+{
+    std::vector<std::pair<size_t, int>> updates;   // <CSV数据行号, 新的车辆数>
+};
+
+// 最短路径树：从source出发按一种权重模式做完整的Dijkstra（不提前停止），保存每个节点在最短路径上的入边
+// 之后从同一起点到任意终点的查询沿入边回溯即可，不需要再搜索
+struct ShortestPathTree
+{
+    uint32_t source;
+    WeightMode mode;
+    std::vector<uint32_t> predecessors;  // 节点ID -> 入边ID，起点和不可达的节点为Graph::INVALID_ID
+    size_t edge_count;                   // 建树时图的边数，用于确认树属于同一张图
+    size_t settled_nodes;                // 建树时确定的节点数（可达节点数）
+
+    ShortestPathTree() : source(0), mode(WeightMode::TIME), edge_count(0), settled_nodes(0) {}
+};
+
+// 多对多距离矩阵
+// 按行存放：第i个起点到第j个终点的元素下标为 i * targets.size() + j
+// 每个元素是按指定权重模式选出的最短路径的总时间和总距离，不可达（或地点不存在）为无穷大
+struct DistanceMatrix
+{
+    std::vector<std::string> sources;
+    std::vector<std::string> targets;
+    std::vector<double> times;      // 总时间（秒）
+    std::vector<double> distances;  // 总距离（米）
+};
+
+// 图类
+// 加载完成后图数据只读，所有查询接口均为const且不修改共享状态，可以被多个线程同时调用
 class Graph
 {
 public:
@@ -36,15 +72,107 @@ public:
     // 从CSV文件加载地图数据来构建图，返回true表示成功，false表示失败
     bool from_csv(const std::string &filename);
 
-    // 查找最短路径（实现Dijkstra算法），返回PathResult包含路径和代价
+    // 二进制快照：解析好的图（节点名表、CSR、各列边属性及预先算好的time和balanced_score）
+    // 原样写入文件，之后通过内存映射直接载入，不再解析文本
+    // 快照中记录了BPR和综合权重参数，参数不同时视为无效
+    bool save_binary(const std::string &filename) const;
+    bool load_binary(const std::string &filename);
+
+    // 增量加载同一路网的下一个快照（如 map_0700.csv 之后的 map_0900.csv），分两步：
+    // compare_snapshot只读取filename并与当前图核对拓扑：逐行的道路ID、起终点、方向以及长度、限速、车道数都相同，
+    // 记下车辆数发生变化的行；拓扑不一致或文件无法读取时返回false，调用方应改用from_csv完整加载。
+    // 它不修改图，调用方可以先核对共享中的图，确认可以增量加载后再复制
+    bool compare_snapshot(const std::string &filename, SnapshotDelta &delta) const;
+
+    // 应用compare_snapshot得到的差异（必须由拓扑相同的图得到）：只更新车辆数发生变化的道路并重新计算这些边的time；
+    // time的取值范围没有变化时只重算这些边的综合评分，否则所有边重新归一化
+    // changed_edges: 输出time被重新计算的边ID
+    void apply_snapshot(const SnapshotDelta &delta, std::vector<uint32_t> &changed_edges);
+
+    // 查找最短路径，返回PathResult包含路径和代价
     // mode: 权重模式（TIME/DISTANCE/BALANCED）
-    PathResult find_shortest_path(const std::string &start, const std::string &end, WeightMode mode = WeightMode::TIME);
+    // 使用的搜索算法由 SearchConfig::algorithm 决定；
+    // 需要预处理的算法（ALT、CH、CRP）由对应的查询引擎提供，这里退回到单向Dijkstra
+    PathResult find_shortest_path(const std::string &start, const std::string &end, WeightMode mode = WeightMode::TIME) const;
+
+    // 单模式点对点搜索：给定起终点ID和权重模式返回路径，必须可以被多个线程同时调用
+    using PathSearch = std::function<PathResult(uint32_t source, uint32_t target, WeightMode mode)>;
+
+    // 并行计算三种模式的最短路径，返回MultiPath
+    // 三次搜索分别在独立线程上运行，各自持有自己的搜索状态，只读共享图数据
+    MultiPath find_multi_path(const std::string &start, const std::string &end) const;
+
+    // 同上，但使用指定的搜索实现（供ALT等建立在Graph之上的查询引擎使用）
+    MultiPath find_multi_path(const std::string &start, const std::string &end, const PathSearch &search) const;
+
+    // 单源最短距离：从source出发到所有节点的最短距离（不可达为无穷大）
+    // reverse为true时在反向图上搜索，得到所有节点到source的最短距离
+    std::vector<double> shortest_distances(uint32_t source, WeightMode mode, bool reverse = false) const;
+
+    // 多对多距离矩阵：每个起点做一次单源搜索，所有终点都确定后提前停止
+    // 各起点的搜索分配到线程池中并行执行
+    DistanceMatrix distance_matrix(const std::vector<std::string> &sources, const std::vector<std::string> &targets,
+                                   WeightMode mode) const;
+
+    // 一对多：同一起点的多个终点共用一次搜索（每种模式一次单源Dijkstra，所有终点都确定后提前停止）
+    // 返回的MultiPath与ends一一对应；三种模式在当前线程上依次计算，便于调用方按起点分组并行
+    // 每条路径的settled_nodes为整组共用的那次搜索确定的节点数
+    std::vector<MultiPath> find_multi_paths(const std::string &start, const std::vector<std::string> &ends) const;
+
+    // 最短路径树：从source出发的完整单源Dijkstra，记录每个节点的入边
+    ShortestPathTree shortest_path_tree(uint32_t source, WeightMode mode) const;
+
+    // 沿树回溯tree.source到target的路径（不做搜索），target不可达时路径为空；settled_nodes为0
+    // 树必须由同一张图（或节点和边编号相同的图）建立
+    PathResult path_from_tree(const ShortestPathTree &tree, uint32_t target) const;
 
     // 计算给定路径的总代价
     // path: 节点序列
     // mode: 权重模式（TIME/DISTANCE/BALANCED）
     // 返回: 路径的总代价，如果路径无效返回0
-    double calculate_path_cost(const std::vector<std::string> &path, WeightMode mode);
+    double calculate_path_cost(const std::vector<std::string> &path, WeightMode mode) const;
+
+    // 节点数量（节点ID范围为 [0, node_count())）
+    size_t node_count() const { return node_names.size(); }
+
+    // 有向边数量（边ID范围为 [0, edge_count())）
+    size_t edge_count() const { return edge_targets.size(); }
+
+    // 图占用内存的估计值（字节）：各数组的容量、地点名和道路ID字符串以及名字索引
+    size_t memory_usage() const;
+
+    // 无效节点/边ID
+    static constexpr uint32_t INVALID_ID = std::numeric_limits<uint32_t>::max();
+
+    // 查找地点名对应的ID，不存在时返回INVALID_ID
+    uint32_t find_node(const std::string &name) const;
+
+    // 可达性索引：SearchConfig::reachability启用时由from_csv和load_binary建立
+    // 返回false表示target一定不能从source到达（O(1)）；没有索引时总是返回true
+    bool can_reach(uint32_t source, uint32_t target) const;
+
+    // 强连通分量数，没有建立可达性索引时为0
+    size_t component_count() const { return component_total; }
+
+    // 获取节点ID对应的地点名
+    const std::string &get_node_name(uint32_t id) const { return node_names[id]; }
+
+    // 只读访问CSR结构（供建立在Graph之上的查询引擎使用）
+    const std::vector<uint32_t> &get_offsets() const { return offsets; }
+    const std::vector<uint32_t> &get_edge_sources() const { return edge_sources; }
+    const std::vector<uint32_t> &get_edge_targets() const { return edge_targets; }
+    const std::vector<uint32_t> &get_reverse_offsets() const { return reverse_offsets; }
+    const std::vector<uint32_t> &get_reverse_edges() const { return reverse_edges; }
+
+    // 获取指定模式的权重列（运行时选择，用于非热点路径）
+    const std::vector<double> &weights(WeightMode mode) const;
+
+    // 沿前驱边回溯source到target的路径，把节点ID映射回地点名并累加时间和距离
+    PathResult build_path_result(uint32_t source, uint32_t target,
+                                 const std::vector<uint32_t> &predecessors) const;
+
+    // 根据从source出发的边ID序列构造PathResult
+    PathResult build_path_result(uint32_t source, const std::vector<uint32_t> &edge_path) const;
 
 private:
     // 权重范围结构体（用于归一化）
@@ -56,12 +184,109 @@ private:
         double distance_max;
     };
 
-    // 邻接表
-    // key是地点的名字(string), value是所有从该地点出发的道路(vector of Edges)
-    std::unordered_map<std::string, std::vector<Edge>> adj_list;
+    // 节点名驻留表：加载时把地点名一次性映射为稠密的整数ID，查询全程只使用ID
+    std::vector<std::string> node_names;                 // ID -> 地点名
+    std::unordered_map<std::string, uint32_t> node_ids;  // 地点名 -> ID
+
+    // CSR（压缩稀疏行）邻接表
+    // 节点u的所有出边ID为 [offsets[u], offsets[u + 1])
+    std::vector<uint32_t> offsets;
+
+    // 边属性按列存储（struct-of-arrays），下标为边ID
+    // 搜索时只顺序读取当前模式需要的那一列权重
+    std::vector<uint32_t> edge_sources;        // 起点节点ID
+    std::vector<uint32_t> edge_targets;        // 目标节点ID
+    std::vector<double> edge_lengths;          // 道路长度（米），即DISTANCE模式权重
+    std::vector<double> edge_speed_limits;     // 道路限速（km/h）
+    std::vector<int> edge_lanes;               // 车道数
+    std::vector<int> edge_vehicles;            // 当前车辆数
+    std::vector<double> edge_times;            // 通行时间（秒），即TIME模式权重
+    std::vector<double> edge_balanced_scores;  // 综合评分，即BALANCED模式权重
+
+    // CSV数据行（表头之后的每一行）与边的对应关系，用于增量加载
+    std::vector<std::string> road_ids;         // 每行的道路ID（没有道路ID列或该行被跳过时为空）
+    std::vector<uint32_t> row_edges;           // 第r行对应的正向边ID为 row_edges[2r]，双向路的反向边ID为 row_edges[2r + 1]，不存在为INVALID_ID
+
+    // 当前用于归一化的时间和距离范围
+    WeightRange weight_range;
+
+    // 反向CSR邻接表（用于双向搜索中的反向搜索）
+    // 节点v的所有入边为 reverse_edges[reverse_offsets[v], reverse_offsets[v + 1])，元素为正向边ID
+    std::vector<uint32_t> reverse_offsets;
+    std::vector<uint32_t> reverse_edges;
+
+    // 可达性索引（未启用时为空）
+    // 强连通分量按压缩DAG的拓扑序编号，跨分量的边总是从小编号指向大编号，编号更大的分量不能到达编号更小的分量；
+    // 分量数不超过上限时另外保存分量间的传递闭包，第c行（reach_words个字）的第d位表示分量c可以到达分量d；
+    // 否则保存压缩DAG上一次深度优先遍历的区间标号：c能到达d时 [low[d], post[d]] 一定包含在 [low[c], post[c]] 中
+    std::vector<uint32_t> node_components;  // 节点ID -> 强连通分量编号
+    std::vector<uint64_t> component_reach;  // 传递闭包位图，分量过多时为空
+    std::vector<uint32_t> component_low;    // 区间标号：子孙分量（含自身）中最小的后序编号，有传递闭包时为空
+    std::vector<uint32_t> component_post;   // 区间标号：分量的后序编号
+    size_t component_total;
+    size_t reach_words;
+
+    // 建立可达性索引：迭代的Tarjan算法求强连通分量，再按逆拓扑序合并各后继分量的位图（分量过多时改为区间标号）
+    void build_reachability();
+
+    // 分量from是否可能到达分量to
+    bool component_reaches(uint32_t from, uint32_t to) const;
+
+    // 获取指定模式的权重列（编译期选择，无运行时分支）
+    template <WeightMode Mode>
+    const std::vector<double> &weights() const;
+
+    // 按节点ID查找最短路径，在入口处按优先队列、算法和模式分派到特化的实现
+    PathResult find_shortest_path(uint32_t source, uint32_t target, WeightMode mode) const;
+
+    template <class Queue>
+    PathResult find_shortest_path(uint32_t source, uint32_t target, WeightMode mode) const;
+
+    // 按权重模式和优先队列特化的Dijkstra
+    template <WeightMode Mode, class Queue>
+    PathResult find_shortest_path_impl(uint32_t source, uint32_t target) const;
+
+    // 按权重模式和优先队列特化的双向Dijkstra
+    template <WeightMode Mode, class Queue>
+    PathResult find_shortest_path_bidirectional(uint32_t source, uint32_t target) const;
+
+    // 按优先队列和权重模式特化的距离矩阵
+    template <class Queue>
+    void distance_matrix(DistanceMatrix &matrix, WeightMode mode) const;
+
+    template <WeightMode Mode, class Queue>
+    void distance_matrix_impl(DistanceMatrix &matrix) const;
+
+    // 按优先队列和权重模式特化的一对多搜索，返回与targets一一对应的路径（targets中可以有INVALID_ID）
+    template <class Queue>
+    std::vector<PathResult> find_paths_from(uint32_t source, const std::vector<uint32_t> &targets, WeightMode mode) const;
+
+    template <WeightMode Mode, class Queue>
+    std::vector<PathResult> find_paths_from_impl(uint32_t source, const std::vector<uint32_t> &targets) const;
+
+    // 按优先队列和权重模式特化的最短路径树
+    template <class Queue>
+    ShortestPathTree shortest_path_tree(uint32_t source, WeightMode mode) const;
+    template <WeightMode Mode, class Queue>
+    void shortest_path_tree_impl(ShortestPathTree &tree) const;
+
+    // 按优先队列特化的单源最短距离
+    template <class Queue>
+    std::vector<double> shortest_distances_impl(uint32_t source, WeightMode mode, bool reverse) const;
+
+    // 获取地点名对应的ID，不存在时分配新ID
+    uint32_t intern_node(const std::string &name);
+
+    // 检查正反向CSR和行-边对应关系是否自洽（offsets单调、边的起终点与CSR一致、所有ID在范围内），
+    // 载入二进制快照时使用，避免损坏的文件导致搜索越界
+    bool check_structure() const;
+
 
     // 计算图中所有边的权重范围（用于归一化）
     WeightRange calculate_weight_range() const;
+
+    // 按weight_range计算一条边的综合评分
+    double calculate_balanced_score(size_t e) const;
 };
 
 #endif 
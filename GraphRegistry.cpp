@@ -0,0 +1,67 @@
+#include "GraphRegistry.h"
+
+GraphRegistry::GraphRegistry(size_t memory_budget)
+    : graphs(memory_budget)
+{
+}
+
+std::shared_ptr<const Graph> GraphRegistry::find(const std::string &map_file)
+{
+    FileSignature signature(map_file);
+
+    // 文件被修改过，旧图失效
+    return graphs.find(signature.path, [&](const LoadedGraph &loaded) {
+        return loaded.signature.mtime == signature.mtime && loaded.signature.size == signature.size;
+    }).graph;
+}
+
+void GraphRegistry::insert(const FileSignature &signature, std::shared_ptr<const Graph> graph)
+{
+    size_t bytes = graph->memory_usage();
+    graphs.insert(signature.path, LoadedGraph{signature, std::move(graph)}, bytes);
+}
+
+std::shared_ptr<const Graph> GraphRegistry::acquire(const std::string &map_file, const GraphLoader &loader)
+{
+    std::shared_ptr<const Graph> graph = find(map_file);
+    if (graph != nullptr)
+    {
+        return graph;
+    }
+
+    // 签名在加载前取得：加载期间文件被修改时，下次find会发现签名不一致
+    // 同一地图被多个线程同时加载时，后放入的替换先放入的，内容相同
+    FileSignature signature(map_file);
+    auto loaded = std::make_shared<Graph>();
+    if (!loader(*loaded, map_file))
+    {
+        return nullptr;
+    }
+    insert(signature, loaded);
+    return loaded;
+}
+
+void GraphRegistry::erase(const std::string &map_file)
+{
+    graphs.erase(FileSignature(map_file).path);
+}
+
+size_t GraphRegistry::graph_count() const
+{
+    return graphs.size();
+}
+
+size_t GraphRegistry::memory_usage() const
+{
+    return graphs.memory_usage();
+}
+
+size_t GraphRegistry::get_hit_count() const
+{
+    return graphs.get_hit_count();
+}
+
+size_t GraphRegistry::get_load_count() const
+{
+    return graphs.get_insert_count();
+}
@@ -0,0 +1,56 @@
+#ifndef GRAPH_REGISTRY_H
+#define GRAPH_REGISTRY_H
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include "ByteBudgetLru.h"
+#include "Cache.h"
+#include "Graph.h"
+
+// 进程内的图缓存
+// 以地图文件的FileSignature（规范化路径、修改时间、文件大小）为键保存已加载的图，以只读的shared_ptr共享给调用方。
+// 与PathCache互补：PathCache省去Dijkstra，这里省去解析。
+// 同一路径的签名改变（文件被修改）时旧图失效；已加载的图总内存超过预算时按最久未使用淘汰，
+// 被淘汰的图在调用方释放最后一个shared_ptr后才真正析构。可以被多个线程同时调用
+class GraphRegistry
+{
+public:
+    // 加载地图的函数：成功时把filename的内容载入graph并返回true
+    using GraphLoader = std::function<bool(Graph &graph, const std::string &filename)>;
+
+    // memory_budget: 常驻图的内存预算（字节，按Graph::memory_usage()估计）
+    explicit GraphRegistry(size_t memory_budget);
+
+    // 查找签名与map_file当前签名一致的图，不存在时返回空指针
+    std::shared_ptr<const Graph> find(const std::string &map_file);
+
+    // 放入已加载的图，替换同一路径的旧图，必要时淘汰其他图
+    // signature应在加载前取得：加载期间文件被修改时，下次find会发现签名不一致，不会把旧内容登记在新签名下
+    void insert(const FileSignature &signature, std::shared_ptr<const Graph> graph);
+
+    // find未命中时用loader加载并放入；加载在锁外进行，失败时返回空指针
+    std::shared_ptr<const Graph> acquire(const std::string &map_file, const GraphLoader &loader);
+
+    // 移除map_file对应的图（不论签名），下次acquire时重新加载
+    void erase(const std::string &map_file);
+
+    // 统计信息
+    size_t graph_count() const;
+    size_t memory_usage() const;
+    size_t get_hit_count() const;
+    size_t get_load_count() const;
+
+private:
+    // 图和加载前取得的签名，命中时与文件当前的签名比较
+    struct LoadedGraph
+    {
+        FileSignature signature;
+        std::shared_ptr<const Graph> graph;
+    };
+
+    ByteBudgetLru<LoadedGraph> graphs;                  // 规范化路径 -> 图
+};
+
+#endif // GRAPH_REGISTRY_H
@@ -0,0 +1,146 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+MappedFile::MappedFile() : begin(nullptr), length(0), file_handle(INVALID_HANDLE_VALUE), mapping_handle(nullptr)
+{
+}
+
+bool MappedFile::open(const std::string &filename)
+{
+    close();
+
+    // 允许映射期间继续追加写入和删除文件（路径缓存的段文件边读边写）
+    HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file, &file_size))
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    file_handle = file;
+    length = static_cast<size_t>(file_size.QuadPart);
+    if (length == 0)
+    {
+        return true;  // 空文件无法创建映射
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping == nullptr)
+    {
+        close();
+        return false;
+    }
+    mapping_handle = mapping;
+
+    begin = static_cast<const char *>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    if (begin == nullptr)
+    {
+        close();
+        return false;
+    }
+
+    return true;
+}
+
+void MappedFile::close()
+{
+    if (begin != nullptr)
+    {
+        UnmapViewOfFile(begin);
+    }
+    if (mapping_handle != nullptr)
+    {
+        CloseHandle(mapping_handle);
+    }
+    if (file_handle != INVALID_HANDLE_VALUE)
+    {
+        CloseHandle(file_handle);
+    }
+
+    begin = nullptr;
+    length = 0;
+    file_handle = INVALID_HANDLE_VALUE;
+    mapping_handle = nullptr;
+}
+
+#else
+
+MappedFile::MappedFile() : begin(nullptr), length(0)
+{
+}
+
+bool MappedFile::open(const std::string &filename)
+{
+    close();
+
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) != 0)
+    {
+        ::close(fd);
+        return false;
+    }
+
+    length = static_cast<size_t>(file_stat.st_size);
+    if (length == 0)
+    {
+        ::close(fd);
+        return true;  // 空文件无法映射
+    }
+
+    // 映射建立后即可关闭文件描述符，映射仍然有效
+    void *address = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (address == MAP_FAILED)
+    {
+        length = 0;
+        return false;
+    }
+
+    madvise(address, length, MADV_SEQUENTIAL);
+    begin = static_cast<const char *>(address);
+    return true;
+}
+
+void MappedFile::close()
+{
+    if (begin != nullptr)
+    {
+        munmap(const_cast<char *>(begin), length);
+    }
+
+    begin = nullptr;
+    length = 0;
+}
+
+#endif
+
+MappedFile::~MappedFile()
+{
+    close();
+}
@@ -0,0 +1,40 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+// 只读内存映射文件
+// 把整个文件映射到进程地址空间，内容通过data()/size()直接访问，不经过读缓冲区的复制。
+// Windows使用CreateFileMapping/MapViewOfFile，其他平台使用mmap
+class MappedFile
+{
+public:
+    MappedFile();
+    ~MappedFile();
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    // 映射文件，失败时返回false（空文件也视为成功，size()为0）
+    bool open(const std::string &filename);
+
+    // 解除映射
+    void close();
+
+    const char *data() const { return begin; }
+    size_t size() const { return length; }
+    std::string_view view() const { return std::string_view(begin, length); }
+
+private:
+    const char *begin;
+    size_t length;
+
+#ifdef _WIN32
+    void *file_handle;
+    void *mapping_handle;
+#endif
+};
+
+#endif // MAPPED_FILE_H
@@ -0,0 +1,77 @@
+#include "PathTreeCache.h"
+
+PathTreeCache::PathTreeCache(size_t memory_budget)
+    : trees(memory_budget)
+{
+}
+
+std::string PathTreeCache::make_key(const std::string &map_key, uint32_t source, WeightMode mode)
+{
+    return map_key + "|" + std::to_string(static_cast<int>(mode)) + "|" + std::to_string(source);
+}
+
+MultiPath PathTreeCache::find_multi_path(const Graph &graph, const std::string &map_key,
+                                         const std::string &start, const std::string &end, bool *hit)
+{
+    // 每种模式在自己的线程上只写自己的标志
+    bool built[3] = {false, false, false};
+
+    // 起终点检查和三种模式的并行沿用Graph::find_multi_path
+    MultiPath paths = graph.find_multi_path(start, end, [&](uint32_t source, uint32_t target, WeightMode mode) {
+        std::shared_ptr<const ShortestPathTree> tree = find(graph, map_key, source, mode);
+        if (tree == nullptr)
+        {
+            // 多个线程同时建立同一棵树时，后放入的替换先放入的，内容相同
+            auto created = std::make_shared<ShortestPathTree>(graph.shortest_path_tree(source, mode));
+            insert(map_key, created);
+            tree = created;
+            built[static_cast<int>(mode)] = true;
+        }
+
+        PathResult result = graph.path_from_tree(*tree, target);
+        result.settled_nodes = built[static_cast<int>(mode)] ? tree->settled_nodes : 0;
+        return result;
+    });
+
+    if (hit != nullptr)
+    {
+        *hit = !built[0] && !built[1] && !built[2];
+    }
+    return paths;
+}
+
+std::shared_ptr<const ShortestPathTree> PathTreeCache::find(const Graph &graph, const std::string &map_key,
+                                                            uint32_t source, WeightMode mode)
+{
+    // 节点数或边数不同说明不是同一张图建立的树
+    return trees.find(make_key(map_key, source, mode), [&](const std::shared_ptr<const ShortestPathTree> &tree) {
+        return tree->predecessors.size() == graph.node_count() && tree->edge_count == graph.edge_count();
+    });
+}
+
+void PathTreeCache::insert(const std::string &map_key, std::shared_ptr<const ShortestPathTree> tree)
+{
+    std::string key = make_key(map_key, tree->source, tree->mode);
+    size_t bytes = sizeof(ShortestPathTree) + tree->predecessors.capacity() * sizeof(uint32_t) + key.size();
+    trees.insert(key, std::move(tree), bytes);
+}
+
+size_t PathTreeCache::tree_count() const
+{
+    return trees.size();
+}
+
+size_t PathTreeCache::memory_usage() const
+{
+    return trees.memory_usage();
+}
+
+size_t PathTreeCache::get_hit_count() const
+{
+    return trees.get_hit_count();
+}
+
+size_t PathTreeCache::get_build_count() const
+{
+    return trees.get_insert_count();
+}
@@ -0,0 +1,46 @@
+#ifndef PATH_TREE_CACHE_H
+#define PATH_TREE_CACHE_H
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include "ByteBudgetLru.h"
+#include "Graph.h"
+
+// 进程内的最短路径树缓存（PathCache之下的一层）
+// PathCache每个键只保存一对起终点的结果；这里按(地图签名, 起点, 权重模式)保存从起点出发的完整最短路径树，
+// 同一起点之后到任何终点的查询沿前驱边回溯即可，不需要再搜索。需求集中在少数起点（如仓库）时效果明显。
+// 树只保存每个节点的入边（每个节点4字节），总内存超过预算时按最久未使用淘汰。可以被多个线程同时调用
+class PathTreeCache
+{
+public:
+    // memory_budget: 最短路径树的内存预算（字节）
+    explicit PathTreeCache(size_t memory_budget);
+
+    // 用三种模式的最短路径树回答start到end的查询，缺少的树先建立再放入（三种模式并行）
+    // map_key: 地图文件签名（FileSignature::to_string()），graph必须是该地图载入的图
+    // hit: 可选，输出三种模式是否都由已有的树回答
+    MultiPath find_multi_path(const Graph &graph, const std::string &map_key,
+                              const std::string &start, const std::string &end, bool *hit = nullptr);
+
+    // 查找树，不存在或与graph不对应时返回空指针
+    std::shared_ptr<const ShortestPathTree> find(const Graph &graph, const std::string &map_key,
+                                                 uint32_t source, WeightMode mode);
+
+    // 放入树，替换同一键的旧树，必要时淘汰其他树
+    void insert(const std::string &map_key, std::shared_ptr<const ShortestPathTree> tree);
+
+    // 统计信息
+    size_t tree_count() const;
+    size_t memory_usage() const;
+    size_t get_hit_count() const;
+    size_t get_build_count() const;
+
+private:
+    ByteBudgetLru<std::shared_ptr<const ShortestPathTree>> trees;  // 键 -> 树
+
+    // 树的键：地图签名、权重模式和起点ID
+    static std::string make_key(const std::string &map_key, uint32_t source, WeightMode mode);
+};
+
+#endif // PATH_TREE_CACHE_H
@@ -0,0 +1,245 @@
+#ifndef PRIORITY_QUEUE_H
+#define PRIORITY_QUEUE_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <queue>
+#include <utility>
+#include <vector>
+
+// Dijkstra使用的最小优先队列，以节点ID为元素、距离为键
+// 三种实现提供相同的接口，搜索函数以模板参数选择：
+//   empty()          队列是否为空
+//   top_key()        队首的键（队列非空时调用）
+//   push(node, key)  插入节点；节点已在队列中时降低它的键
+//   pop()            弹出并返回 <键, 节点ID>
+// BinaryHeapQueue和RadixHeapQueue采用惰性删除，可能弹出作废的记录，
+// 调用方需要把弹出的键与已知最短距离比较并跳过作废记录
+
+// 队列元素：<距离, 节点ID>
+using QueueEntry = std::pair<double, uint32_t>;
+
+// 基于std::priority_queue的二叉堆（惰性删除，原实现）
+class BinaryHeapQueue
+{
+public:
+    explicit BinaryHeapQueue(size_t /*node_count*/) {}
+
+    bool empty() const { return heap.empty(); }
+    double top_key() const { return heap.top().first; }
+
+    void push(uint32_t node, double key) { heap.push({key, node}); }
+
+    QueueEntry pop()
+    {
+        QueueEntry top = heap.top();
+        heap.pop();
+        return top;
+    }
+
+private:
+    std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry>> heap;
+};
+
+// 带索引的4叉堆，支持降低键（decrease-key）
+// 每个节点在堆中至多出现一次，不会产生作废记录；
+// 4叉堆比二叉堆矮一半，下沉时比较的4个孩子在内存中相邻
+class IndexedDaryHeap
+{
+public:
+    static constexpr size_t ARITY = 4;
+
+    explicit IndexedDaryHeap(size_t node_count) : position(node_count, NOT_IN_HEAP) {}
+
+    bool empty() const { return heap.empty(); }
+    double top_key() const { return heap.front().first; }
+
+    void push(uint32_t node, double key)
+    {
+        size_t index = position[node];
+        if (index == NOT_IN_HEAP)
+        {
+            index = heap.size();
+            heap.push_back({key, node});
+        }
+        else if (key < heap[index].first)
+        {
+            heap[index].first = key;
+        }
+        else
+        {
+            return;
+        }
+        sift_up(index);
+    }
+
+    QueueEntry pop()
+    {
+        QueueEntry top = heap.front();
+        position[top.second] = NOT_IN_HEAP;
+
+        QueueEntry last = heap.back();
+        heap.pop_back();
+        if (!heap.empty())
+        {
+            heap[0] = last;
+            sift_down(0);
+        }
+        return top;
+    }
+
+private:
+    static constexpr uint32_t NOT_IN_HEAP = UINT32_MAX;
+
+    std::vector<QueueEntry> heap;
+    std::vector<uint32_t> position;     // 节点ID -> 在heap中的下标
+
+    void sift_up(size_t index)
+    {
+        QueueEntry entry = heap[index];
+        while (index > 0)
+        {
+            size_t parent = (index - 1) / ARITY;
+            if (heap[parent].first <= entry.first)
+            {
+                break;
+            }
+            heap[index] = heap[parent];
+            position[heap[index].second] = static_cast<uint32_t>(index);
+            index = parent;
+        }
+        heap[index] = entry;
+        position[entry.second] = static_cast<uint32_t>(index);
+    }
+
+    void sift_down(size_t index)
+    {
+        QueueEntry entry = heap[index];
+        const size_t size = heap.size();
+        while (true)
+        {
+            size_t first_child = index * ARITY + 1;
+            if (first_child >= size)
+            {
+                break;
+            }
+
+            size_t last_child = std::min(first_child + ARITY, size);
+            size_t smallest = first_child;
+            for (size_t child = first_child + 1; child < last_child; ++child)
+            {
+                if (heap[child].first < heap[smallest].first)
+                {
+                    smallest = child;
+                }
+            }
+
+            if (entry.first <= heap[smallest].first)
+            {
+                break;
+            }
+            heap[index] = heap[smallest];
+            position[heap[index].second] = static_cast<uint32_t>(index);
+            index = smallest;
+        }
+        heap[index] = entry;
+        position[entry.second] = static_cast<uint32_t>(index);
+    }
+};
+
+// 单调基数堆（radix heap）
+// 要求插入的键不小于最近一次弹出的键，Dijkstra的边权非负，天然满足这一条件。
+// 非负double的IEEE 754位模式按无符号整数比较与按数值比较的顺序相同，
+// 因此以位模式作为整数键：键与最近弹出的键的最高不同位决定所在的桶，
+// 每个元素只会向更低的桶移动，总共至多移动64次
+class RadixHeapQueue
+{
+public:
+    explicit RadixHeapQueue(size_t /*node_count*/) : last(0), count(0) {}
+
+    bool empty() const { return count == 0; }
+
+    double top_key()
+    {
+        refill();
+        return to_double(last);
+    }
+
+    void push(uint32_t node, double key)
+    {
+        uint64_t bits = to_bits(key);
+        buckets[bucket_index(bits)].push_back({bits, node});
+        count++;
+    }
+
+    QueueEntry pop()
+    {
+        refill();
+        RadixEntry entry = buckets[0].back();
+        buckets[0].pop_back();
+        count--;
+        return {to_double(entry.first), entry.second};
+    }
+
+private:
+    using RadixEntry = std::pair<uint64_t, uint32_t>;
+
+    // 桶0存放键等于last的元素，桶i（i >= 1）存放与last最高不同位为第i-1位的元素
+    std::vector<RadixEntry> buckets[65];
+    uint64_t last;      // 最近一次弹出的键（位模式）
+    size_t count;
+
+    static uint64_t to_bits(double key)
+    {
+        key += 0.0;     // 把-0.0规范为+0.0，其位模式带有符号位
+        uint64_t bits;
+        std::memcpy(&bits, &key, sizeof(bits));
+        return bits;
+    }
+
+    static double to_double(uint64_t bits)
+    {
+        double key;
+        std::memcpy(&key, &bits, sizeof(key));
+        return key;
+    }
+
+    size_t bucket_index(uint64_t bits) const
+    {
+        return bits == last ? 0 : 64 - static_cast<size_t>(__builtin_clzll(bits ^ last));
+    }
+
+    // 桶0为空时，找到第一个非空的桶，以其中的最小键为新的last并重新分配该桶
+    void refill()
+    {
+        if (!buckets[0].empty())
+        {
+            return;
+        }
+
+        size_t i = 1;
+        while (buckets[i].empty())
+        {
+            i++;
+        }
+
+        uint64_t minimum = buckets[i][0].first;
+        for (const RadixEntry &entry : buckets[i])
+        {
+            if (entry.first < minimum)
+            {
+                minimum = entry.first;
+            }
+        }
+
+        last = minimum;
+        for (const RadixEntry &entry : buckets[i])
+        {
+            buckets[bucket_index(entry.first)].push_back(entry);
+        }
+        buckets[i].clear();
+    }
+};
+
+#endif // PRIORITY_QUEUE_H
@@ -0,0 +1,361 @@
+#include "RoutingServer.h"
+#include "ThreadPool.h"
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+#include <csignal>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    // 按空格拆分请求行；含有制表符时按制表符拆分
+    std::vector<std::string> split_request(const std::string &line)
+    {
+        std::vector<std::string> fields;
+        char separator = line.find('\t') != std::string::npos ? '\t' : ' ';
+
+        std::string field;
+        std::istringstream stream(line);
+        while (std::getline(stream, field, separator))
+        {
+            if (!field.empty())
+            {
+                fields.push_back(field);
+            }
+        }
+        return fields;
+    }
+
+    // 把一条路径写成一行："<标签> <时间> <距离> <地点1> --> <地点2> ..."，不可达为"<标签> none"
+    void write_path_line(std::ostringstream &out, const char *label, const PathResult &result)
+    {
+        out << label;
+        if (result.path.empty())
+        {
+            out << " none\n";
+            return;
+        }
+
+        out << " " << result.time << " " << result.distance << " ";
+        for (size_t i = 0; i < result.path.size(); ++i)
+        {
+            out << result.path[i] << (i == result.path.size() - 1 ? "" : " --> ");
+        }
+        out << "\n";
+    }
+
+#ifndef _WIN32
+    // 发送完整的响应，发送失败时标记关闭连接
+    void send_response(int client, const std::string &response, bool &close_connection)
+    {
+        for (size_t sent = 0; sent < response.size();)
+        {
+            ssize_t written = send(client, response.data() + sent, response.size() - sent, 0);
+            if (written <= 0)
+            {
+                close_connection = true;
+                return;
+            }
+            sent += static_cast<size_t>(written);
+        }
+    }
+#endif
+}
+
+RoutingServer::RoutingServer(GraphRegistry &graphs, GraphRegistry::GraphLoader loader, PathCache *cache,
+                             PathTreeCache *trees)
+    : graphs(graphs), loader(std::move(loader)), cache(cache), trees(trees)
+{
+}
+
+void RoutingServer::log(const std::string &message)
+{
+    std::lock_guard<std::mutex> lock(log_mutex);
+    std::cout << message << std::endl;
+}
+
+std::string RoutingServer::handle_query(const std::string &start, const std::string &end, const std::string &map_file)
+{
+    auto begin = std::chrono::steady_clock::now();
+    std::ostringstream response;
+
+    MultiPath paths;
+    bool cache_hit = false;
+    bool tree_hit = false;
+    if (cache != nullptr)
+    {
+        paths = cache->get(start, end, map_file, &cache_hit);
+    }
+
+    if (!cache_hit)
+    {
+        std::shared_ptr<const Graph> graph = graphs.acquire(map_file, loader);
+        if (graph == nullptr)
+        {
+            return "ERR could not load map " + map_file + "\nEND\n";
+        }
+        if (graph->find_node(start) == Graph::INVALID_ID)
+        {
+            return "ERR start node not found: " + start + "\nEND\n";
+        }
+
+        auto search_begin = std::chrono::steady_clock::now();
+        if (trees != nullptr)
+        {
+            paths = trees->find_multi_path(*graph, FileSignature(map_file).to_string(), start, end, &tree_hit);
+        }
+        else
+        {
+            paths = graph->find_multi_path(start, end);
+        }
+        if (cache != nullptr)
+        {
+            std::chrono::duration<double, std::milli> search_elapsed = std::chrono::steady_clock::now() - search_begin;
+            cache->put(start, end, map_file, paths, search_elapsed.count());
+        }
+    }
+
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - begin;
+    response << "OK latency_ms=" << elapsed.count()
+             << " cache=" << (cache == nullptr ? "off" : cache_hit ? "hit" : "miss");
+    if (trees != nullptr && !cache_hit)
+    {
+        response << " tree=" << (tree_hit ? "hit" : "built");
+    }
+    response << "\n";
+    write_path_line(response, "TIME", paths.time_path);
+    write_path_line(response, "DISTANCE", paths.distance_path);
+    write_path_line(response, "BALANCED", paths.balanced_path);
+    response << "END\n";
+
+    std::ostringstream message;
+    message << "[Server] query " << start << " -> " << end << " on " << map_file << ": "
+            << elapsed.count() << " ms (" << (cache_hit ? "hit" : "miss") << ")";
+    log(message.str());
+    return response.str();
+}
+
+std::string RoutingServer::handle_reload(const std::string &map_file)
+{
+    auto begin = std::chrono::steady_clock::now();
+    graphs.erase(map_file);
+    std::shared_ptr<const Graph> graph = graphs.acquire(map_file, loader);
+    if (graph == nullptr)
+    {
+        return "ERR could not load map " + map_file + "\nEND\n";
+    }
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - begin;
+
+    std::ostringstream response;
+    response << "OK latency_ms=" << elapsed.count() << " nodes=" << graph->node_count()
+             << " edges=" << graph->edge_count() << "\nEND\n";
+
+    std::ostringstream message;
+    message << "[Server] reload " << map_file << ": " << elapsed.count() << " ms";
+    log(message.str());
+    return response.str();
+}
+
+std::string RoutingServer::handle_stats()
+{
+    std::ostringstream response;
+    response << "OK graphs=" << graphs.graph_count() << " graph_bytes=" << graphs.memory_usage();
+    if (cache != nullptr)
+    {
+        response << " cache_hits=" << cache->get_hit_count() << " cache_misses=" << cache->get_miss_count()
+                 << " cache_entries=" << cache->get_entry_count();
+    }
+    if (trees != nullptr)
+    {
+        response << " trees=" << trees->tree_count() << " tree_bytes=" << trees->memory_usage()
+                 << " tree_hits=" << trees->get_hit_count();
+    }
+    response << "\nEND\n";
+    return response.str();
+}
+
+std::string RoutingServer::handle_request(const std::string &line, bool &close_connection)
+{
+    std::vector<std::string> fields = split_request(line);
+    if (fields.empty())
+    {
+        return "ERR empty request\nEND\n";
+    }
+
+    const std::string &command = fields[0];
+    if (command == "query" && fields.size() == 4)
+    {
+        return handle_query(fields[1], fields[2], fields[3]);
+    }
+    if (command == "reload" && fields.size() == 2)
+    {
+        return handle_reload(fields[1]);
+    }
+    if (command == "stats" && fields.size() == 1)
+    {
+        return handle_stats();
+    }
+    if (command == "quit")
+    {
+        close_connection = true;
+        return "OK bye\nEND\n";
+    }
+    return "ERR usage: query <start> <end> <map> | reload <map> | stats | quit\nEND\n";
+}
+
+#ifdef _WIN32
+
+bool RoutingServer::run(const std::string &)
+{
+    std::cerr << "Error: --serve requires Unix domain sockets and is not supported on Windows" << std::endl;
+    return false;
+}
+
+void RoutingServer::serve_client(int)
+{
+}
+
+#else
+
+bool RoutingServer::run(const std::string &socket_path)
+{
+    // 客户端提前断开时send返回错误而不是终止进程
+    std::signal(SIGPIPE, SIG_IGN);
+
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (socket_path.size() >= sizeof(address.sun_path))
+    {
+        std::cerr << "Error: Socket path is too long: " << socket_path << std::endl;
+        return false;
+    }
+    socket_path.copy(address.sun_path, socket_path.size());
+
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0)
+    {
+        std::cerr << "Error: Could not create socket" << std::endl;
+        return false;
+    }
+
+    // 删除上次运行留下的套接字文件；路径上是其他文件时（例如参数写错）不能删除
+    struct stat existing;
+    if (lstat(socket_path.c_str(), &existing) == 0)
+    {
+        if (!S_ISSOCK(existing.st_mode))
+        {
+            std::cerr << "Error: " << socket_path << " exists and is not a socket" << std::endl;
+            close(listener);
+            return false;
+        }
+        unlink(socket_path.c_str());
+    }
+    if (bind(listener, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0 || listen(listener, 64) != 0)
+    {
+        std::cerr << "Error: Could not listen on " << socket_path << std::endl;
+        close(listener);
+        return false;
+    }
+    log("[Server] Listening on " + socket_path);
+
+    ThreadPool sessions(ServerConfig::max_clients);
+    while (true)
+    {
+        // 连接数达到上限时等待某个连接关闭后再accept
+        {
+            std::unique_lock<std::mutex> lock(client_mutex);
+            client_finished.wait(lock, [this]() { return active_clients < ServerConfig::max_clients; });
+        }
+
+        int client = accept(listener, nullptr, nullptr);
+        if (client < 0)
+        {
+            int error = errno;
+            if (error == EINTR || error == ECONNABORTED)
+            {
+                continue;
+            }
+
+            // 文件描述符耗尽等错误不会立即消失，稍后再试，避免空转
+            log(std::string("[Server] accept failed: ") + std::strerror(error));
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            continue;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(client_mutex);
+            active_clients++;
+        }
+        sessions.submit([this, client]() {
+            serve_client(client);
+
+            std::lock_guard<std::mutex> lock(client_mutex);
+            active_clients--;
+            client_finished.notify_one();
+        });
+    }
+}
+
+void RoutingServer::serve_client(int client)
+{
+    std::string pending;
+    char buffer[4096];
+    bool close_connection = false;
+
+    while (!close_connection)
+    {
+        ssize_t received = recv(client, buffer, sizeof(buffer), 0);
+        if (received <= 0)
+        {
+            break;
+        }
+        pending.append(buffer, static_cast<size_t>(received));
+
+        // 依次处理缓冲区中所有完整的请求行
+        size_t line_end;
+        while (!close_connection && (line_end = pending.find('\n')) != std::string::npos)
+        {
+            std::string line = pending.substr(0, line_end);
+            pending.erase(0, line_end + 1);
+            if (!line.empty() && line.back() == '\r')
+            {
+                line.pop_back();
+            }
+
+            send_response(client, handle_request(line, close_connection), close_connection);
+        }
+
+        // 剩下的是尚未结束的请求行，超过上限时不再等待换行，避免缓冲区无限增长
+        if (!close_connection && pending.size() > ServerConfig::max_request_bytes)
+        {
+            send_response(client, "ERR request too long\nEND\n", close_connection);
+            close_connection = true;
+
+            // 带着未读数据关闭会让客户端收到连接重置而读不到错误响应：先关闭写方向，再丢弃有限的剩余输入
+            shutdown(client, SHUT_WR);
+            for (size_t discarded = 0; discarded < ServerConfig::max_request_bytes;)
+            {
+                received = recv(client, buffer, sizeof(buffer), 0);
+                if (received <= 0)
+                {
+                    break;
+                }
+                discarded += static_cast<size_t>(received);
+            }
+        }
+    }
+
+    close(client);
+}
+
+#endif
@@ -0,0 +1,68 @@
+#ifndef ROUTING_SERVER_H
+#define ROUTING_SERVER_H
+
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include "Cache.h"
+#include "Graph.h"
+#include "GraphRegistry.h"
+#include "PathTreeCache.h"
+
+// 常驻路由服务
+// 在Unix域套接字上监听，客户端连接由固定大小的线程池处理，同时处理的连接数不超过ServerConfig::max_clients，
+// 达到上限时暂停accept，新连接在监听队列中等待。已加载的Graph（GraphRegistry）和PathCache常驻内存，
+// 同一地图的后续查询不再解析CSV。请求和响应都是按行的文本协议（UTF-8，行尾为\n）：
+//   query <起点> <终点> <地图文件>   查询三种路径
+//   reload <地图文件>               重新加载地图（正在进行的查询继续使用旧图）
+//   stats                          缓存和已加载地图的统计
+//   quit                           关闭连接
+// 字段之间用空格分隔；若请求行中含有制表符，则改用制表符分隔（用于含空格的地名或路径）。
+// 请求行超过ServerConfig::max_request_bytes仍未结束时回复"ERR request too long"并关闭连接。
+// 每个响应的第一行为"OK ..."或"ERR <原因>"，最后一行为"END"。query的响应：
+//   OK latency_ms=<耗时> cache=<hit|miss|off> [tree=<hit|built>]   （启用最短路径树缓存时有tree字段）
+//   TIME <时间> <距离> <地点1> --> <地点2> --> ...     （不可达时为 TIME none）
+//   DISTANCE ...
+//   BALANCED ...
+//   END
+class RoutingServer
+{
+public:
+    // graphs保存常驻的图，loader在图未加载或已失效时加载地图
+    // cache为nullptr时不使用缓存，trees为nullptr时不使用最短路径树缓存；
+    // graphs、cache和trees由调用方持有，生命周期需长于服务
+    RoutingServer(GraphRegistry &graphs, GraphRegistry::GraphLoader loader, PathCache *cache, PathTreeCache *trees);
+
+    // 在socket_path上监听并处理请求，正常情况下不返回；无法监听时输出错误并返回false
+    // socket_path已存在时只删除上次运行留下的套接字文件，其他类型的文件不删除，输出错误并返回false
+    // Windows上不支持，直接返回false
+    bool run(const std::string &socket_path);
+
+private:
+    // 图以shared_ptr共享：reload时替换登记的图，已经取得旧图的查询不受影响
+    GraphRegistry &graphs;
+    GraphRegistry::GraphLoader loader;
+    PathCache *cache;
+    PathTreeCache *trees;
+
+    std::mutex log_mutex;   // 保证日志按行输出
+
+    std::mutex client_mutex;
+    std::condition_variable client_finished;    // 有连接关闭
+    size_t active_clients = 0;                  // 正在处理的连接数，受client_mutex保护
+
+    // 处理一个客户端连接直到对方关闭或发送quit
+    void serve_client(int client);
+
+    // 处理一行请求，返回完整的响应（含END行）；quit时把close_connection置为true
+    std::string handle_request(const std::string &line, bool &close_connection);
+
+    std::string handle_query(const std::string &start, const std::string &end, const std::string &map_file);
+    std::string handle_reload(const std::string &map_file);
+    std::string handle_stats();
+
+    // 输出一行日志
+    void log(const std::string &message);
+};
+
+#endif // ROUTING_SERVER_H
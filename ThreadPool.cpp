@@ -0,0 +1,77 @@
+#include "ThreadPool.h"
+#include <algorithm>
+
+ThreadPool::ThreadPool(size_t thread_count) : active(0), stopping(false)
+{
+    if (thread_count == 0)
+    {
+        thread_count = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    workers.reserve(thread_count);
+    for (size_t i = 0; i < thread_count; ++i)
+    {
+        workers.emplace_back(&ThreadPool::worker_loop, this);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    task_ready.notify_all();
+
+    for (std::thread &worker : workers)
+    {
+        worker.join();
+    }
+}
+
+void ThreadPool::submit(std::function<void()> task)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        tasks.push(std::move(task));
+    }
+    task_ready.notify_one();
+}
+
+void ThreadPool::wait()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    all_done.wait(lock, [this]() { return tasks.empty() && active == 0; });
+}
+
+// 工作线程：取出任务执行，线程池关闭且队列为空时退出
+void ThreadPool::worker_loop()
+{
+    while (true)
+    {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            task_ready.wait(lock, [this]() { return stopping || !tasks.empty(); });
+            if (tasks.empty())
+            {
+                return;
+            }
+
+            task = std::move(tasks.front());
+            tasks.pop();
+            active++;
+        }
+
+        task();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            active--;
+            if (tasks.empty() && active == 0)
+            {
+                all_done.notify_all();
+            }
+        }
+    }
+}
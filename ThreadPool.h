@@ -0,0 +1,48 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+// 固定大小的线程池
+// 任务按提交顺序取出执行；wait()阻塞到所有已提交的任务执行完毕，之后可以继续提交
+class ThreadPool
+{
+public:
+    // thread_count为0时使用硬件并发数
+    explicit ThreadPool(size_t thread_count = 0);
+
+    // 等待剩余任务执行完毕后结束所有工作线程
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    // 提交任务，任务内部不应抛出异常
+    void submit(std::function<void()> task);
+
+    // 等待所有已提交的任务执行完毕
+    void wait();
+
+    // 工作线程数
+    size_t size() const { return workers.size(); }
+
+private:
+    std::vector<std::thread> workers;
+    std::queue<std::function<void()>> tasks;
+
+    std::mutex mutex;
+    std::condition_variable task_ready;     // 有新任务或线程池正在关闭
+    std::condition_variable all_done;       // 队列为空且没有正在执行的任务
+    size_t active;                          // 正在执行的任务数
+    bool stopping;
+
+    void worker_loop();
+};
+
+#endif // THREAD_POOL_H
@@ -8,6 +8,25 @@ double BPRConfig::lane_capacity = 1800.0;
 // 缓存参数默认值
 size_t CacheConfig::max_size = 50;
 std::string CacheConfig::cache_dir = ".cache";
+size_t CacheConfig::shard_count = 8;
+CachePolicy CacheConfig::policy = CachePolicy::LRU;
+bool CacheConfig::content_keys = false;
+size_t CacheConfig::segment_compact_bytes = 1024 * 1024;
+size_t CacheConfig::graph_memory_budget = 512 * 1024 * 1024;
+bool CacheConfig::graph_snapshots = true;
+bool CacheConfig::tree_cache = false;
+size_t CacheConfig::tree_memory_budget = 64 * 1024 * 1024;
+
+// 常驻服务参数默认值
+size_t ServerConfig::max_clients = 64;
+size_t ServerConfig::max_request_bytes = 64 * 1024;
+
+// 搜索参数默认值
+SearchAlgorithm SearchConfig::algorithm = SearchAlgorithm::DIJKSTRA;
+size_t SearchConfig::landmark_count = 8;
+size_t SearchConfig::cell_size = 128;
+QueueType SearchConfig::queue = QueueType::DARY_HEAP;
+bool SearchConfig::reachability = false;
 
 // 综合路径权重参数默认值
 double PathWeightConfig::time_factor = 0.6;
@@ -11,6 +11,32 @@ enum class WeightMode
     BALANCED    // 综合推荐（时间和距离的归一化加权平均）
 };
 
+// 最短路径搜索算法
+enum class SearchAlgorithm
+{
+    DIJKSTRA,       // 单向Dijkstra（弹出终点即停止）
+    BIDIRECTIONAL,  // 双向Dijkstra（正向图与反向图同时搜索）
+    ALT,            // 地标A*（需要预处理地标距离表，见ALT.h）
+    CH,             // 收缩层次（需要预处理捷径边，见CH.h）
+    CRP,            // 可定制路径规划（拓扑预处理一次，每个快照只重新定制，见CRP.h）
+    DYNAMIC         // 动态最短路径树（跨快照保存起点的最短路径树，只修复受影响的子树，见DynamicSSSP.h）
+};
+
+// Dijkstra使用的优先队列（见PriorityQueue.h）
+enum class QueueType
+{
+    BINARY_HEAP,    // std::priority_queue二叉堆（惰性删除）
+    DARY_HEAP,      // 带索引的4叉堆（降低键）
+    RADIX_HEAP      // 单调基数堆
+};
+
+// 路径缓存的淘汰策略（见Cache.h）
+enum class CachePolicy
+{
+    LRU,        // 最久未使用
+    TINY_LFU    // W-TinyLFU准入，按访问频率、计算代价和记录大小淘汰
+};
+
 // BPR 函数配置参数
 struct BPRConfig
 {
@@ -24,6 +50,31 @@ struct CacheConfig
 {
     static size_t max_size;         // LRU 缓存最大条目数，默认 50
     static std::string cache_dir;   // 缓存目录路径，默认 ".cache"
+    static size_t shard_count;      // 缓存分片数，每个分片有自己的锁、LRU和索引文件，默认 8
+    static CachePolicy policy;      // 淘汰策略，默认 LRU
+    static bool content_keys;       // 缓存键使用地图文件的内容指纹而不是路径和修改时间，默认 false
+    static size_t segment_compact_bytes;    // 段文件中失效记录超过该字节数且多于有效记录时后台压缩，默认 1 MB
+    static size_t graph_memory_budget;  // 进程内常驻图的内存预算（字节），默认 512 MB
+    static bool graph_snapshots;    // 读写二进制图快照（cache_dir/graphs/），--no-cache时关闭，默认 true
+    static bool tree_cache;         // 保存每个起点的完整最短路径树，同一起点的后续查询不再搜索，默认 false
+    static size_t tree_memory_budget;   // 进程内最短路径树的内存预算（字节），默认 64 MB
+};
+
+// 常驻服务配置参数
+struct ServerConfig
+{
+    static size_t max_clients;      // 同时处理的客户端连接数上限，达到上限时暂停accept，默认 64
+    static size_t max_request_bytes; // 单个请求行的长度上限，超过时回复错误并关闭连接，默认 64 KB
+};
+
+// 搜索配置参数
+struct SearchConfig
+{
+    static SearchAlgorithm algorithm;   // 最短路径搜索算法，默认 DIJKSTRA
+    static size_t landmark_count;       // ALT地标数量，默认 8
+    static size_t cell_size;            // CRP单元最多包含的节点数，默认 128
+    static QueueType queue;             // Dijkstra/双向Dijkstra使用的优先队列，默认 DARY_HEAP
+    static bool reachability;           // 加载地图时建立强连通分量可达性索引，不可达的查询立即返回，默认 false
 };
 
 // 综合路径权重配置参数
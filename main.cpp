@@ -2,18 +2,417 @@
 #include <vector>
 #include <string>
 #include <filesystem>
+#include <chrono>
+#include <sstream>
+#include <mutex>
+#include <algorithm>
+#include <unordered_map>
+#include <memory>
 #include "Graph.h"
+#include "ALT.h"
+#include "CH.h"
+#include "CRP.h"
+#include "DynamicSSSP.h"
 #include "Cache.h"
 #include "config.h"
 #include "util.h"
+#include "ThreadPool.h"
+#include "RoutingServer.h"
+#include "GraphRegistry.h"
+#include "PathTreeCache.h"
+
+// 二进制图快照的路径：<路径哈希>_<签名哈希>.bin，同一地图文件的各个版本有相同的前缀
+std::string graph_snapshot_file(const FileSignature &signature)
+{
+    std::filesystem::path graph_dir = std::filesystem::path(CacheConfig::cache_dir) / "graphs";
+    return (graph_dir / (signature.path_key() + "_" + signature.to_key() + ".bin")).string();
+}
+
+// 写入二进制图快照，并删除同一地图文件的旧版本快照（文件被修改前写入的）以及旧命名方式的快照
+void save_graph_snapshot(const Graph &city_map, const std::string &graph_file)
+{
+    try
+    {
+        std::filesystem::path snapshot(graph_file);
+        std::filesystem::create_directories(snapshot.parent_path());
+        if (!city_map.save_binary(graph_file))
+        {
+            return;
+        }
+
+        std::string file_name = snapshot.filename().string();
+        std::string prefix = file_name.substr(0, file_name.find('_') + 1);
+        for (const auto &entry : std::filesystem::directory_iterator(snapshot.parent_path()))
+        {
+            std::string name = entry.path().filename().string();
+            bool stale = name != file_name && name.compare(0, prefix.size(), prefix) == 0;
+            bool legacy = name.find('_') == std::string::npos;
+            if (entry.path().extension() == ".bin" && (stale || legacy))
+            {
+                std::error_code ignored;
+                std::filesystem::remove(entry.path(), ignored);
+            }
+        }
+    }
+    catch (const std::filesystem::filesystem_error &e)
+    {
+        std::cerr << "Warning: Could not write graph snapshot: " << e.what() << std::endl;
+    }
+}
+
+// 加载地图：优先载入缓存目录中的二进制快照，不存在或损坏时解析CSV并写入快照（--no-cache时不读写快照）
+bool load_map(Graph &city_map, const std::string &map_file)
+{
+    std::string graph_file = graph_snapshot_file(FileSignature(map_file));
+    if (CacheConfig::graph_snapshots && city_map.load_binary(graph_file))
+    {
+        return true;
+    }
+
+    if (!city_map.from_csv(map_file))
+    {
+        return false;
+    }
+    if (CacheConfig::graph_snapshots)
+    {
+        save_graph_snapshot(city_map, graph_file);
+    }
+    return true;
+}
+
+// 加载地图对应的地标距离表，不存在时重新预处理并保存到缓存目录
+void prepare_landmarks(ALTEngine &alt, const std::string &map_file, std::ostream &out)
+{
+    std::filesystem::path landmark_dir = std::filesystem::path(CacheConfig::cache_dir) / "landmarks";
+    std::string landmark_file = (landmark_dir / (FileSignature(map_file).to_key() + ".alt")).string();
+
+    if (alt.load(landmark_file))
+    {
+        out << "[ALT] Loaded " << alt.landmark_count() << " landmarks from " << landmark_file << std::endl;
+        return;
+    }
+
+    auto build_begin = std::chrono::steady_clock::now();
+    alt.build(SearchConfig::landmark_count);
+    std::chrono::duration<double, std::milli> build_elapsed = std::chrono::steady_clock::now() - build_begin;
+    out << "[ALT] Preprocessed " << alt.landmark_count() << " landmarks in " << build_elapsed.count() << " ms" << std::endl;
+
+    try
+    {
+        std::filesystem::create_directories(landmark_dir);
+        alt.save(landmark_file);
+    }
+    catch (const std::filesystem::filesystem_error &e)
+    {
+        std::cerr << "Warning: Could not create landmark directory: " << e.what() << std::endl;
+    }
+}
+
+// 预处理收缩层次，预处理耗时与查询耗时分开报告
+void prepare_contraction_hierarchies(CHEngine &ch, std::ostream &out)
+{
+    auto build_begin = std::chrono::steady_clock::now();
+    ch.build();
+    std::chrono::duration<double, std::milli> build_elapsed = std::chrono::steady_clock::now() - build_begin;
+    out << "[CH] Preprocessed in " << build_elapsed.count() << " ms, shortcuts (time/distance/balanced): "
+        << ch.shortcut_count(WeightMode::TIME) << "/"
+        << ch.shortcut_count(WeightMode::DISTANCE) << "/"
+        << ch.shortcut_count(WeightMode::BALANCED) << std::endl;
+}
+
+// 进程内的图缓存：同一次运行中再次用到同一地图（签名不变）时直接共享已加载的图
+GraphRegistry &graph_registry()
+{
+    static GraphRegistry registry(CacheConfig::graph_memory_budget);
+    return registry;
+}
+
+// 常驻服务的最短路径树缓存（--tree-cache）：同一地图上起点相同的查询沿树回溯，不再搜索
+// 树只保存在进程内，命令行模式下每个快照只处理一次，树不会被再次使用，因此只用于常驻服务
+PathTreeCache &path_trees()
+{
+    static PathTreeCache trees(CacheConfig::tree_memory_budget);
+    return trees;
+}
+
+// 在同一测试用例的多个地图快照之间共享的状态
+struct SnapshotState
+{
+    std::shared_ptr<const Graph> city_map;  // 最近一次加载的快照，拓扑不变时下一个快照在它的副本上增量更新
+    CRPEngine crp;  // CRP的拓扑预处理，拓扑不变时各快照只需重新定制
+    DynamicEngine dynamic;  // 上一个快照的最短路径树，起点不变时只修复受影响的部分
+    std::shared_ptr<const Graph> engine_graph;  // alt/ch建立在其上的图，持有它以保证引擎中的引用有效
+    std::unique_ptr<ALTEngine> alt;  // 所选算法为ALT时的地标距离表，图不变时直接复用
+    std::unique_ptr<CHEngine> ch;    // 所选算法为CH时的收缩层次，图不变时直接复用
+};
+
+// 加载当前快照：进程内已有签名相同的图时直接共享；有二进制快照时直接载入；
+// 否则若上一个快照仍在内存中且拓扑相同，只更新车辆数变化的道路；都不满足时完整解析CSV
+bool load_snapshot(SnapshotState &state, const std::string &map_file, std::ostream &out)
+{
+    std::shared_ptr<const Graph> resident = graph_registry().find(map_file);
+    if (resident != nullptr)
+    {
+        state.city_map = resident;
+        return true;
+    }
+
+    // 签名在加载前取得：加载期间文件被修改时，下次查找会发现签名不一致
+    FileSignature signature(map_file);
+    auto city_map = std::make_shared<Graph>();
+    std::string graph_file = graph_snapshot_file(signature);
+    if (!CacheConfig::graph_snapshots || !city_map->load_binary(graph_file))
+    {
+        // 先在上一个快照上核对拓扑（只读），可以增量更新时才复制；
+        // 上一个快照可能正被其他调用方共享，更新在副本上进行
+        SnapshotDelta delta;
+        if (state.city_map != nullptr && state.city_map->compare_snapshot(map_file, delta))
+        {
+            std::vector<uint32_t> changed_edges;
+            *city_map = *state.city_map;
+            city_map->apply_snapshot(delta, changed_edges);
+            out << "[Graph] Updated incrementally from previous snapshot, changed edges: "
+                << changed_edges.size() << "/" << city_map->edge_count() << std::endl;
+        }
+        else if (!city_map->from_csv(map_file))
+        {
+            return false;
+        }
+        if (CacheConfig::graph_snapshots)
+        {
+            save_graph_snapshot(*city_map, graph_file);
+        }
+    }
+
+    graph_registry().insert(signature, city_map);
+    state.city_map = city_map;
+    return true;
+}
+
+// 准备ALT或CH：只建立所选算法的引擎；当前快照的图与上次相同（共享同一个Graph）时直接复用，不再预处理
+void prepare_point_to_point_engine(SnapshotState &state, const std::string &map_file, std::ostream &out)
+{
+    bool is_alt = SearchConfig::algorithm == SearchAlgorithm::ALT;
+    if (state.engine_graph == state.city_map && (is_alt ? state.alt != nullptr : state.ch != nullptr))
+    {
+        out << (is_alt ? "[ALT] Graph unchanged, reusing landmarks" : "[CH] Graph unchanged, reusing hierarchy") << std::endl;
+        return;
+    }
+
+    state.alt.reset();
+    state.ch.reset();
+    state.engine_graph = state.city_map;
+    if (is_alt)
+    {
+        state.alt = std::make_unique<ALTEngine>(*state.city_map);
+        prepare_landmarks(*state.alt, map_file, out);
+    }
+    else
+    {
+        state.ch = std::make_unique<CHEngine>(*state.city_map);
+        prepare_contraction_hierarchies(*state.ch, out);
+    }
+}
+
+// 准备CRP：拓扑变化时重新预处理，然后用当前快照的权重定制覆盖图
+void prepare_customizable_route_planning(CRPEngine &crp, const Graph &city_map, std::ostream &out)
+{
+    if (!crp.matches_topology(city_map))
+    {
+        auto preprocess_begin = std::chrono::steady_clock::now();
+        crp.preprocess(city_map, SearchConfig::cell_size);
+        std::chrono::duration<double, std::milli> preprocess_elapsed = std::chrono::steady_clock::now() - preprocess_begin;
+        out << "[CRP] Preprocessed topology in " << preprocess_elapsed.count() << " ms, cells: "
+            << crp.cell_count() << ", boundary nodes: " << crp.boundary_node_count() << std::endl;
+    }
+    else
+    {
+        out << "[CRP] Topology unchanged, reusing partition" << std::endl;
+    }
+
+    auto customize_begin = std::chrono::steady_clock::now();
+    crp.customize(city_map);
+    std::chrono::duration<double, std::milli> customize_elapsed = std::chrono::steady_clock::now() - customize_begin;
+    out << "[CRP] Customized overlay in " << customize_elapsed.count() << " ms" << std::endl;
+}
+
+// 比较三种优先队列的查询耗时
+// 对每个地图快照，用当前算法（dijkstra或bidirectional）在每种队列上重复查询，报告平均耗时，
+// 并检查三种队列给出的路径长度是否一致
+void run_queue_benchmark(const std::vector<std::string> &map_files, const std::string &start_node,
+                         const std::string &end_node)
+{
+    const int repeat = 20;
+    const QueueType queues[3] = {QueueType::BINARY_HEAP, QueueType::DARY_HEAP, QueueType::RADIX_HEAP};
+    const QueueType configured_queue = SearchConfig::queue;
+
+    std::cout << "\n[Benchmark] Algorithm: " << search_algorithm_name(SearchConfig::algorithm)
+              << ", " << repeat << " runs per queue" << std::endl;
+
+    for (const auto &map_file : map_files)
+    {
+        std::shared_ptr<const Graph> graph = graph_registry().acquire(map_file, load_map);
+        if (graph == nullptr)
+        {
+            std::cerr << "Error: Failed to load map file " << map_file << std::endl;
+            continue;
+        }
+        const Graph &city_map = *graph;
+
+        std::cout << "[Benchmark] " << std::filesystem::path(map_file).filename().string() << ":";
+        MultiPath reference;
+        bool consistent = true;
+
+        for (int q = 0; q < 3; ++q)
+        {
+            SearchConfig::queue = queues[q];
+            MultiPath paths;
+
+            auto begin = std::chrono::steady_clock::now();
+            for (int i = 0; i < repeat; ++i)
+            {
+                paths = city_map.find_multi_path(start_node, end_node);
+            }
+            std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - begin;
+            std::cout << " " << queue_type_name(queues[q]) << " " << elapsed.count() / repeat << " ms";
+
+            if (q == 0)
+            {
+                reference = paths;
+            }
+            else if (paths.time_path.time != reference.time_path.time ||
+                     paths.distance_path.distance != reference.distance_path.distance ||
+                     paths.balanced_path.path.size() != reference.balanced_path.path.size())
+            {
+                consistent = false;
+            }
+        }
+        std::cout << std::endl;
+
+        if (!consistent)
+        {
+            std::cerr << "Warning: Priority queues returned different paths on " << map_file << std::endl;
+        }
+    }
+
+    SearchConfig::queue = configured_queue;
+}
+
+// 对每个地图快照计算多对多距离矩阵并写入文件
+// 输出文件名为 <matrix_file的文件名>_<地图文件名><扩展名>，例如 matrix_map_0700.csv
+void run_distance_matrix(const std::vector<std::string> &map_files, const std::string &demand_file,
+                         const std::string &matrix_file, WeightMode mode)
+{
+    std::vector<std::string> sources, targets;
+    if (!read_matrix_demand(demand_file, sources, targets))
+    {
+        return;
+    }
+    std::cout << "\n[Matrix] " << sources.size() << " origins x " << targets.size() << " destinations" << std::endl;
+
+    std::filesystem::path output(matrix_file);
+    SnapshotState state;
+    for (const auto &map_file : map_files)
+    {
+        if (!load_snapshot(state, map_file, std::cout))
+        {
+            std::cerr << "Error: Failed to load map file " << map_file << std::endl;
+            continue;
+        }
+
+        auto begin = std::chrono::steady_clock::now();
+        DistanceMatrix matrix = state.city_map->distance_matrix(sources, targets, mode);
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - begin;
+
+        std::filesystem::path map_path(map_file);
+        std::filesystem::path output_file = output.parent_path() /
+            (output.stem().string() + "_" + map_path.stem().string() + output.extension().string());
+        if (write_distance_matrix(matrix, output_file.string()))
+        {
+            std::cout << "[Matrix] " << map_path.filename().string() << ": computed in " << elapsed.count()
+                      << " ms, written to " << output_file.string() << std::endl;
+        }
+    }
+}
+
+// 批量请求模式：按起点分组，每组一次共用的一对多搜索，各组分配到线程池中并行执行
+// 每个快照只加载一次；某一组算完后立即输出该组的所有请求（各组之间的输出顺序不固定）
+void run_batch(const std::vector<std::string> &map_files, const std::string &demand_file)
+{
+    std::vector<std::pair<std::string, std::string>> requests;
+    if (!read_batch_demand(demand_file, requests))
+    {
+        return;
+    }
+
+    // 按起点分组，组的顺序为起点第一次出现的顺序；每组保存请求下标
+    std::vector<std::string> origins;
+    std::vector<std::vector<size_t>> groups;
+    std::unordered_map<std::string, size_t> group_of;
+    for (size_t i = 0; i < requests.size(); ++i)
+    {
+        auto [it, inserted] = group_of.emplace(requests[i].first, groups.size());
+        if (inserted)
+        {
+            origins.push_back(requests[i].first);
+            groups.emplace_back();
+        }
+        groups[it->second].push_back(i);
+    }
+    std::cout << "\n[Batch] " << requests.size() << " requests from " << groups.size() << " origins" << std::endl;
+
+    SnapshotState state;
+    ThreadPool pool(std::min<size_t>(groups.size(), std::thread::hardware_concurrency()));
+    std::mutex output_mutex;
+    for (const auto &map_file : map_files)
+    {
+        std::cout << "\n========================================================" << std::endl;
+        std::cout << "Processing map: " << map_file << std::endl;
+        std::cout << "========================================================" << std::endl;
+
+        if (!load_snapshot(state, map_file, std::cout))
+        {
+            std::cerr << "Error: Failed to load map file " << map_file << std::endl;
+            continue;
+        }
+
+        auto begin = std::chrono::steady_clock::now();
+        const Graph &city_map = *state.city_map;
+        for (size_t g = 0; g < groups.size(); ++g)
+        {
+            pool.submit([&, g]() {
+                std::vector<std::string> ends;
+                ends.reserve(groups[g].size());
+                for (size_t i : groups[g])
+                {
+                    ends.push_back(requests[i].second);
+                }
+                std::vector<MultiPath> paths = city_map.find_multi_paths(origins[g], ends);
+
+                std::lock_guard<std::mutex> lock(output_mutex);
+                for (size_t k = 0; k < paths.size(); ++k)
+                {
+                    std::cout << "\nRequest #" << groups[g][k] + 1 << ": Find path from \"" << origins[g]
+                              << "\" to \"" << ends[k] << "\"." << std::endl;
+                    print_multi_paths(paths[k]);
+                }
+            });
+        }
+        pool.wait();
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - begin;
+
+        std::cout << "[Batch] " << std::filesystem::path(map_file).filename().string() << ": " << requests.size()
+                  << " requests in " << groups.size() << " groups, elapsed: " << elapsed.count() << " ms" << std::endl;
+    }
+}
 
 // 处理单个地图文件，查找并打印最短路径
 void process_map(const std::string &map_file, const std::string &start_node, const std::string &end_node,
-                 PathCache *cache, bool use_cache)
+                 PathCache *cache, bool use_cache, SnapshotState &state, std::ostream &out)
 {
-    std::cout << "\n========================================================" << std::endl;
-    std::cout << "Processing map: " << map_file << std::endl;
-    std::cout << "========================================================" << std::endl;
+    out << "\n========================================================" << std::endl;
+    out << "Processing map: " << map_file << std::endl;
+    out << "========================================================" << std::endl;
 
     MultiPath cached_paths;
     bool cache_hit = false;
@@ -21,27 +420,25 @@ void process_map(const std::string &map_file, const std::string &start_node, con
     // 尝试从缓存获取（如果启用缓存）
     if (use_cache && cache != nullptr)
     {
-        // 记录查询前的hit_count，通过hit_count变化判断是否命中
-        size_t old_hit_count = cache->get_hit_count();
-        cached_paths = cache->get(start_node, end_node, map_file);
-        cache_hit = (cache->get_hit_count() > old_hit_count);
+        // 由get直接报告是否命中（其他线程可能同时查询，hit_count的变化不可靠）
+        cached_paths = cache->get(start_node, end_node, map_file, &cache_hit);
 
         if (cache_hit)
         {
-            std::cout << "\n[Cache Hit] Using cached results.\n" << std::endl;
+            out << "\n[Cache Hit] Using cached results.\n" << std::endl;
         }
         else
         {
-            std::cout << "\n[Cache Miss] Computing paths using three different strategies...\n" << std::endl;
+            out << "\n[Cache Miss] Computing paths using three different strategies...\n" << std::endl;
         }
     }
     else if (!use_cache)
     {
-        std::cout << "\n[Cache Disabled] Computing paths using three different strategies...\n" << std::endl;
+        out << "\n[Cache Disabled] Computing paths using three different strategies...\n" << std::endl;
     }
     else
     {
-        std::cout << "\nComputing paths using three different strategies...\n" << std::endl;
+        out << "\nComputing paths using three different strategies...\n" << std::endl;
     }
 
     MultiPath paths;
@@ -54,28 +451,109 @@ void process_map(const std::string &map_file, const std::string &start_node, con
     else
     {
         // 缓存未命中或禁用缓存，执行Dijkstra算法
-        Graph city_map;
-        if (!city_map.from_csv(map_file))
+        if (!load_snapshot(state, map_file, out))
         {
             std::cerr << "Error: Failed to load map file " << map_file << std::endl;
             return;
         }
+        const Graph &city_map = *state.city_map;
 
-        // 计算三种路径（find_shortest_path已自动计算time和distance）
-        paths.time_path = city_map.find_shortest_path(start_node, end_node, WeightMode::TIME);
-        paths.distance_path = city_map.find_shortest_path(start_node, end_node, WeightMode::DISTANCE);
-        paths.balanced_path = city_map.find_shortest_path(start_node, end_node, WeightMode::BALANCED);
+        // 需要预处理的算法先准备查询引擎（预处理耗时单独统计）
+        if (SearchConfig::algorithm == SearchAlgorithm::ALT || SearchConfig::algorithm == SearchAlgorithm::CH)
+        {
+            prepare_point_to_point_engine(state, map_file, out);
+        }
+        else if (SearchConfig::algorithm == SearchAlgorithm::CRP)
+        {
+            prepare_customizable_route_planning(state.crp, city_map, out);
+        }
+
+        // 并行计算三种路径（每条路径都已自动计算time和distance）
+        auto search_begin = std::chrono::steady_clock::now();
+        if (SearchConfig::algorithm == SearchAlgorithm::ALT)
+        {
+            paths = state.alt->find_multi_path(start_node, end_node);
+        }
+        else if (SearchConfig::algorithm == SearchAlgorithm::CH)
+        {
+            paths = state.ch->find_multi_path(start_node, end_node);
+        }
+        else if (SearchConfig::algorithm == SearchAlgorithm::CRP)
+        {
+            paths = state.crp.find_multi_path(start_node, end_node);
+        }
+        else if (SearchConfig::algorithm == SearchAlgorithm::DYNAMIC)
+        {
+            paths = state.dynamic.find_multi_path(city_map, start_node, end_node);
+        }
+        else
+        {
+            paths = city_map.find_multi_path(start_node, end_node);
+        }
+        std::chrono::duration<double, std::milli> search_elapsed = std::chrono::steady_clock::now() - search_begin;
+        print_search_statistics(paths, search_elapsed.count(), out);
+        if (SearchConfig::algorithm == SearchAlgorithm::DYNAMIC)
+        {
+            out << "[Dynamic] Touched nodes (time/distance/balanced): "
+                << state.dynamic.tree(WeightMode::TIME).touched_nodes() << "/"
+                << state.dynamic.tree(WeightMode::DISTANCE).touched_nodes() << "/"
+                << state.dynamic.tree(WeightMode::BALANCED).touched_nodes()
+                << ", full recomputation: "
+                << state.dynamic.tree(WeightMode::TIME).tree_size() << "/"
+                << state.dynamic.tree(WeightMode::DISTANCE).tree_size() << "/"
+                << state.dynamic.tree(WeightMode::BALANCED).tree_size() << std::endl;
+        }
 
         // 保存到缓存（如果启用缓存）
         // 注意：即使路径为空（无路径），也应该缓存，避免重复计算
         if (use_cache && cache != nullptr)
         {
-            cache->put(start_node, end_node, map_file, paths);
+            cache->put(start_node, end_node, map_file, paths, search_elapsed.count());
         }
     }
 
     // 输出所有三种路径
-    print_multi_paths(paths);
+    print_multi_paths(paths, out);
+}
+
+// 并行处理地图快照：按时间顺序把快照切成jobs段连续的区间，每段由一个工作线程依次处理，
+// 并持有自己的SnapshotState，段内仍然可以增量加载、复用CRP划分和修复动态最短路径树
+// 每个快照的输出先写入自己的缓冲区；某个快照处理完后，从下一个待输出的快照开始，
+// 把已经完成的缓冲区依次写到标准输出，因此输出顺序与串行处理相同
+void process_maps_parallel(const std::vector<std::string> &map_files, const std::string &start_node,
+                           const std::string &end_node, PathCache *cache, bool use_cache, size_t jobs)
+{
+    const size_t count = map_files.size();
+    jobs = std::min(jobs, count);
+
+    std::vector<std::ostringstream> outputs(count);
+    std::vector<char> finished(count, 0);
+    size_t next_output = 0;
+    std::mutex output_mutex;
+
+    ThreadPool pool(jobs);
+    for (size_t w = 0; w < jobs; ++w)
+    {
+        size_t begin = count * w / jobs;
+        size_t end = count * (w + 1) / jobs;
+        pool.submit([&, begin, end]() {
+            SnapshotState state;
+            for (size_t i = begin; i < end; ++i)
+            {
+                process_map(map_files[i], start_node, end_node, cache, use_cache, state, outputs[i]);
+
+                std::lock_guard<std::mutex> lock(output_mutex);
+                finished[i] = 1;
+                while (next_output < count && finished[next_output])
+                {
+                    std::cout << outputs[next_output].str() << std::flush;
+                    outputs[next_output].str(std::string()); // 已输出的缓冲区立即释放
+                    next_output++;
+                }
+            }
+        });
+    }
+    pool.wait();
 }
 
 int main(int argc, char *argv[])
@@ -92,10 +570,14 @@ int main(int argc, char *argv[])
 
         try
         {
-            PathCache cache(CacheConfig::cache_dir, CacheConfig::max_size);
+            PathCache cache(CacheConfig::cache_dir, CacheConfig::max_size, CacheConfig::shard_count, CacheConfig::policy);
             size_t entry_count = cache.get_entry_count();
             cache.clear();
 
+            // 同时删除预处理数据（地标距离表、二进制图快照）
+            std::filesystem::remove_all(std::filesystem::path(CacheConfig::cache_dir) / "landmarks");
+            std::filesystem::remove_all(std::filesystem::path(CacheConfig::cache_dir) / "graphs");
+
             std::cout << "Cache cleared successfully!" << std::endl;
             std::cout << "  Removed " << entry_count << " cache entries." << std::endl;
             std::cout << "  Cache directory: " << CacheConfig::cache_dir << std::endl;
@@ -118,6 +600,12 @@ int main(int argc, char *argv[])
 
     std::string test_path;
     bool use_cache = true; // 默认启用缓存
+    bool benchmark = false;
+    bool batch = false;
+    size_t jobs = 1;
+    std::string serve_socket;
+    std::string matrix_file;
+    WeightMode matrix_mode = WeightMode::TIME;
 
     // 解析所有参数
     for (int i = 1; i < argc; i++)
@@ -141,6 +629,120 @@ int main(int argc, char *argv[])
         else if (arg == "--no-cache")
         {
             use_cache = false;
+            CacheConfig::graph_snapshots = false;
+        }
+        else if (arg == "--cache-policy")
+        {
+            if (i + 1 < argc && parse_cache_policy(argv[i + 1], CacheConfig::policy))
+            {
+                i++; // 跳过下一个参数（策略名）
+            }
+            else
+            {
+                std::cerr << "Error: --cache-policy requires one of: lru, tinylfu" << std::endl;
+                print_usage();
+                return 1;
+            }
+        }
+        else if (arg == "--content-keys")
+        {
+            CacheConfig::content_keys = true;
+        }
+        else if (arg == "--tree-cache")
+        {
+            CacheConfig::tree_cache = true;
+        }
+        else if (arg == "--algorithm")
+        {
+            if (i + 1 < argc && parse_search_algorithm(argv[i + 1], SearchConfig::algorithm))
+            {
+                i++; // 跳过下一个参数（算法名）
+            }
+            else
+            {
+                std::cerr << "Error: --algorithm requires one of: dijkstra, bidirectional, alt, ch, crp, dynamic" << std::endl;
+                print_usage();
+                return 1;
+            }
+        }
+        else if (arg == "--queue")
+        {
+            if (i + 1 < argc && parse_queue_type(argv[i + 1], SearchConfig::queue))
+            {
+                i++; // 跳过下一个参数（队列名）
+            }
+            else
+            {
+                std::cerr << "Error: --queue requires one of: binary, dary, radix" << std::endl;
+                print_usage();
+                return 1;
+            }
+        }
+        else if (arg == "--reachability")
+        {
+            SearchConfig::reachability = true;
+        }
+        else if (arg == "--benchmark")
+        {
+            benchmark = true;
+        }
+        else if (arg == "--jobs")
+        {
+            if (i + 1 < argc && parse_job_count(argv[i + 1], jobs))
+            {
+                i++; // 跳过下一个参数（线程数）
+            }
+            else
+            {
+                std::cerr << "Error: --jobs requires a positive integer" << std::endl;
+                print_usage();
+                return 1;
+            }
+        }
+        else if (arg == "--serve")
+        {
+            if (i + 1 < argc)
+            {
+                serve_socket = argv[i + 1];
+                i++; // 跳过下一个参数（套接字路径）
+            }
+            else
+            {
+                std::cerr << "Error: --serve requires a socket path argument" << std::endl;
+                print_usage();
+                return 1;
+            }
+        }
+        else if (arg == "--batch")
+        {
+            batch = true;
+        }
+        else if (arg == "--matrix")
+        {
+            if (i + 1 < argc)
+            {
+                matrix_file = argv[i + 1];
+                i++; // 跳过下一个参数（输出文件）
+            }
+            else
+            {
+                std::cerr << "Error: --matrix requires an output file argument" << std::endl;
+                print_usage();
+                return 1;
+            }
+        }
+        else if (arg == "--matrix-mode")
+        {
+            if (i + 1 < argc && parse_weight_mode(argv[i + 1], matrix_mode))
+            {
+                i++; // 跳过下一个参数（权重模式）
+            }
+            else
+            {
+                std::cerr << "Error: --matrix-mode requires one of: time, distance, balanced" << std::endl;
+                print_usage();
+                return 1;
+            }
         }
         else if (arg == "--clear-cache")
         {
@@ -156,6 +758,43 @@ int main(int argc, char *argv[])
         }
     }
 
+    // 最短路径树由完整的Dijkstra建立，只有常驻服务能重复使用
+    if (CacheConfig::tree_cache && serve_socket.empty())
+    {
+        std::cerr << "Error: --tree-cache can only be used with --serve" << std::endl;
+        print_usage();
+        return 1;
+    }
+    if (CacheConfig::tree_cache && SearchConfig::algorithm != SearchAlgorithm::DIJKSTRA)
+    {
+        std::cerr << "Error: --tree-cache requires --algorithm dijkstra" << std::endl;
+        print_usage();
+        return 1;
+    }
+
+    // 常驻服务模式：地图和缓存常驻内存，直到进程被终止
+    if (!serve_socket.empty())
+    {
+        // 服务只保存图，不保存ALT/CH/CRP/dynamic的预处理结果，只支持直接在图上搜索的算法
+        if (SearchConfig::algorithm != SearchAlgorithm::DIJKSTRA &&
+            SearchConfig::algorithm != SearchAlgorithm::BIDIRECTIONAL)
+        {
+            std::cerr << "Error: --serve supports only --algorithm dijkstra or bidirectional" << std::endl;
+            print_usage();
+            return 1;
+        }
+
+        PathCache *cache = nullptr;
+        if (use_cache)
+        {
+            cache = new PathCache(CacheConfig::cache_dir, CacheConfig::max_size, CacheConfig::shard_count, CacheConfig::policy);
+        }
+        RoutingServer server(graph_registry(), load_map, cache, CacheConfig::tree_cache ? &path_trees() : nullptr);
+        bool served = server.run(serve_socket);
+        delete cache;
+        return served ? 0 : 1;
+    }
+
     if (test_path.empty())
     {
         std::cerr << "Error: --test-path is required" << std::endl;
@@ -178,6 +817,20 @@ int main(int argc, char *argv[])
         return 1;
     }
 
+    // 距离矩阵模式：demand文件中的所有起点 × 所有终点
+    if (!matrix_file.empty())
+    {
+        run_distance_matrix(map_files, demand_file, matrix_file, matrix_mode);
+        return 0;
+    }
+
+    // 批量请求模式：demand文件中的每一对起点和终点都是一个请求，不使用缓存
+    if (batch)
+    {
+        run_batch(map_files, demand_file);
+        return 0;
+    }
+
     // 读取起点和终点
     std::string start_node, end_node;
     if (!read_demand(demand_file, start_node, end_node))
@@ -186,11 +839,18 @@ int main(int argc, char *argv[])
     }
     std::cout << "Request: Find path from \"" << start_node << "\" to \"" << end_node << "\"." << std::endl;
 
+    // 基准测试模式：只比较优先队列的耗时，不使用缓存也不打印路径
+    if (benchmark)
+    {
+        run_queue_benchmark(map_files, start_node, end_node);
+        return 0;
+    }
+
     // 创建缓存对象（如果启用缓存）
     PathCache *cache = nullptr;
     if (use_cache)
     {
-        cache = new PathCache(CacheConfig::cache_dir, CacheConfig::max_size);
+        cache = new PathCache(CacheConfig::cache_dir, CacheConfig::max_size, CacheConfig::shard_count, CacheConfig::policy);
         std::cout << "\n[Cache] Cache enabled. Max entries: " << CacheConfig::max_size << std::endl;
     }
     else
@@ -199,9 +859,17 @@ int main(int argc, char *argv[])
     }
 
     // 处理每个地图文件
-    for (const auto &map_file : map_files)
+    if (jobs > 1)
     {
-        process_map(map_file, start_node, end_node, cache, use_cache);
+        process_maps_parallel(map_files, start_node, end_node, cache, use_cache, jobs);
+    }
+    else
+    {
+        SnapshotState state;
+        for (const auto &map_file : map_files)
+        {
+            process_map(map_file, start_node, end_node, cache, use_cache, state, std::cout);
+        }
     }
 
     // 输出缓存统计信息
@@ -6,6 +6,7 @@
 #include <algorithm>
 #include <cmath>
 #include <limits>
+#include <charconv>
 
 const std::string start_prefix = "起点：";
 const std::string end_prefix = "终点：";
@@ -97,50 +98,393 @@ bool read_demand(const std::string &filename, std::string &start, std::string &e
     return true;
 }
 
+// 读取距离矩阵的起点和终点（按出现顺序）
+bool read_matrix_demand(const std::string &filename, std::vector<std::string> &sources, std::vector<std::string> &targets)
+{
+    std::ifstream file(filename);
+    if (!file.is_open())
+    {
+        std::cerr << "Error: Could not open demand file " << filename << std::endl;
+        return false;
+    }
+
+    std::string line;
+    while (std::getline(file, line))
+    {
+        // 移除字符串末尾可能存在的回车符
+        if (!line.empty() && line.back() == '\r')
+        {
+            line.pop_back();
+        }
+
+        if (line.rfind(start_prefix, 0) == 0)
+        {
+            sources.push_back(trim(line.substr(start_prefix.length())));
+        }
+
+        if (line.rfind(end_prefix, 0) == 0)
+        {
+            targets.push_back(trim(line.substr(end_prefix.length())));
+        }
+    }
+
+    if (sources.empty() || targets.empty())
+    {
+        std::cerr << "Error: Could not find start or end node in " << filename << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+// 读取批量请求：每一行"起点："开始一个新请求，其后的第一行"终点："是该请求的终点
+bool read_batch_demand(const std::string &filename, std::vector<std::pair<std::string, std::string>> &requests)
+{
+    std::ifstream file(filename);
+    if (!file.is_open())
+    {
+        std::cerr << "Error: Could not open demand file " << filename << std::endl;
+        return false;
+    }
+
+    std::string line;
+    std::string start;
+    size_t line_number = 0;
+    while (std::getline(file, line))
+    {
+        line_number++;
+
+        // 移除字符串末尾可能存在的回车符
+        if (!line.empty() && line.back() == '\r')
+        {
+            line.pop_back();
+        }
+
+        if (line.rfind(start_prefix, 0) == 0)
+        {
+            if (!start.empty())
+            {
+                std::cerr << "Warning: Start node '" << start << "' has no end node in " << filename
+                          << ", skipped." << std::endl;
+            }
+            start = trim(line.substr(start_prefix.length()));
+        }
+
+        if (line.rfind(end_prefix, 0) == 0)
+        {
+            if (start.empty())
+            {
+                std::cerr << "Warning: End node without start node at line " << line_number << " of " << filename
+                          << ", skipped." << std::endl;
+                continue;
+            }
+            requests.push_back({start, trim(line.substr(end_prefix.length()))});
+            start.clear();
+        }
+    }
+
+    if (!start.empty())
+    {
+        std::cerr << "Warning: Start node '" << start << "' has no end node in " << filename << ", skipped." << std::endl;
+    }
+
+    if (requests.empty())
+    {
+        std::cerr << "Error: Could not find start or end node in " << filename << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+// 保存距离矩阵
+// CSV：表头为 起点,终点,时间(秒),距离(米)，不可达的元素时间和距离留空
+// 二进制：魔数"MTX1" | 起点数 | 终点数（uint32）| 各起点名、各终点名（uint32长度 + 字节）|
+//        times [起点数 × 终点数] | distances [起点数 × 终点数]（double，按行存放，不可达为无穷大）
+bool write_distance_matrix(const DistanceMatrix &matrix, const std::string &filename)
+{
+    bool binary = std::filesystem::path(filename).extension() == ".bin";
+    std::ofstream file(filename, binary ? std::ios::binary | std::ios::trunc : std::ios::trunc);
+    if (!file.is_open())
+    {
+        std::cerr << "Error: Could not write distance matrix to " << filename << std::endl;
+        return false;
+    }
+
+    const size_t column_count = matrix.targets.size();
+
+    if (binary)
+    {
+        auto write_u32 = [&file](uint32_t value) {
+            file.write(reinterpret_cast<const char *>(&value), sizeof(value));
+        };
+        auto write_name = [&](const std::string &name) {
+            write_u32(static_cast<uint32_t>(name.size()));
+            file.write(name.data(), name.size());
+        };
+
+        file.write("MTX1", 4);
+        write_u32(static_cast<uint32_t>(matrix.sources.size()));
+        write_u32(static_cast<uint32_t>(column_count));
+        for (const std::string &name : matrix.sources)
+            write_name(name);
+        for (const std::string &name : matrix.targets)
+            write_name(name);
+        file.write(reinterpret_cast<const char *>(matrix.times.data()), matrix.times.size() * sizeof(double));
+        file.write(reinterpret_cast<const char *>(matrix.distances.data()), matrix.distances.size() * sizeof(double));
+        return static_cast<bool>(file);
+    }
+
+    file.precision(10);
+    file << "起点,终点,时间(秒),距离(米)\n";
+    for (size_t row = 0; row < matrix.sources.size(); ++row)
+    {
+        for (size_t column = 0; column < column_count; ++column)
+        {
+            size_t index = row * column_count + column;
+            file << matrix.sources[row] << "," << matrix.targets[column] << ",";
+            if (matrix.times[index] != std::numeric_limits<double>::infinity())
+            {
+                file << matrix.times[index] << "," << matrix.distances[index];
+            }
+            else
+            {
+                file << ",";
+            }
+            file << "\n";
+        }
+    }
+    return static_cast<bool>(file);
+}
+
+// 解析权重模式名称
+bool parse_weight_mode(const std::string &name, WeightMode &mode)
+{
+    if (name == "time")
+    {
+        mode = WeightMode::TIME;
+        return true;
+    }
+    if (name == "distance")
+    {
+        mode = WeightMode::DISTANCE;
+        return true;
+    }
+    if (name == "balanced")
+    {
+        mode = WeightMode::BALANCED;
+        return true;
+    }
+    return false;
+}
+
+// 解析搜索算法名称
+bool parse_search_algorithm(const std::string &name, SearchAlgorithm &algorithm)
+{
+    if (name == "dijkstra")
+    {
+        algorithm = SearchAlgorithm::DIJKSTRA;
+        return true;
+    }
+    if (name == "bidirectional")
+    {
+        algorithm = SearchAlgorithm::BIDIRECTIONAL;
+        return true;
+    }
+    if (name == "alt")
+    {
+        algorithm = SearchAlgorithm::ALT;
+        return true;
+    }
+    if (name == "ch")
+    {
+        algorithm = SearchAlgorithm::CH;
+        return true;
+    }
+    if (name == "crp")
+    {
+        algorithm = SearchAlgorithm::CRP;
+        return true;
+    }
+    if (name == "dynamic")
+    {
+        algorithm = SearchAlgorithm::DYNAMIC;
+        return true;
+    }
+    return false;
+}
+
+// 获取搜索算法的名称
+std::string search_algorithm_name(SearchAlgorithm algorithm)
+{
+    switch (algorithm)
+    {
+    case SearchAlgorithm::BIDIRECTIONAL:
+        return "bidirectional";
+    case SearchAlgorithm::ALT:
+        return "alt";
+    case SearchAlgorithm::CH:
+        return "ch";
+    case SearchAlgorithm::CRP:
+        return "crp";
+    case SearchAlgorithm::DYNAMIC:
+        return "dynamic";
+    case SearchAlgorithm::DIJKSTRA:
+    default:
+        return "dijkstra";
+    }
+}
+
+// 解析优先队列名称
+bool parse_queue_type(const std::string &name, QueueType &queue)
+{
+    if (name == "binary")
+    {
+        queue = QueueType::BINARY_HEAP;
+        return true;
+    }
+    if (name == "dary")
+    {
+        queue = QueueType::DARY_HEAP;
+        return true;
+    }
+    if (name == "radix")
+    {
+        queue = QueueType::RADIX_HEAP;
+        return true;
+    }
+    return false;
+}
+
+// 获取优先队列的名称
+std::string queue_type_name(QueueType queue)
+{
+    switch (queue)
+    {
+    case QueueType::BINARY_HEAP:
+        return "binary";
+    case QueueType::RADIX_HEAP:
+        return "radix";
+    case QueueType::DARY_HEAP:
+    default:
+        return "dary";
+    }
+}
+
+// 解析缓存淘汰策略名称
+bool parse_cache_policy(const std::string &name, CachePolicy &policy)
+{
+    if (name == "lru")
+    {
+        policy = CachePolicy::LRU;
+        return true;
+    }
+    if (name == "tinylfu")
+    {
+        policy = CachePolicy::TINY_LFU;
+        return true;
+    }
+    return false;
+}
+
+// 获取缓存淘汰策略的名称
+std::string cache_policy_name(CachePolicy policy)
+{
+    switch (policy)
+    {
+    case CachePolicy::TINY_LFU:
+        return "tinylfu";
+    case CachePolicy::LRU:
+    default:
+        return "lru";
+    }
+}
+
+// 解析并行处理快照的线程数
+bool parse_job_count(const std::string &text, size_t &jobs)
+{
+    size_t value = 0;
+    auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+    if (error != std::errc() || end != text.data() + text.size() || value == 0)
+    {
+        return false;
+    }
+    jobs = value;
+    return true;
+}
+
 // 打印使用说明
 void print_usage()
 {
-    std::cout << "Usage: .\\pathfinder --test-path <path_to_test_case_directory> [--no-cache]" << std::endl;
+    std::cout << "Usage: .\\pathfinder --test-path <path_to_test_case_directory> [--no-cache] [--cache-policy <name>] [--content-keys] [--algorithm <name>] [--queue <name>] [--reachability] [--benchmark] [--jobs <n>]" << std::endl;
+    std::cout << "       .\\pathfinder --test-path <path_to_test_case_directory> --matrix <output.csv|output.bin> [--matrix-mode <mode>] [--reachability]" << std::endl;
+    std::cout << "       .\\pathfinder --test-path <path_to_test_case_directory> --batch [--queue <name>] [--reachability]" << std::endl;
+    std::cout << "       .\\pathfinder --serve <socket_path> [--no-cache] [--cache-policy <name>] [--content-keys] [--tree-cache] [--algorithm dijkstra|bidirectional] [--queue <name>] [--reachability]" << std::endl;
     std::cout << "       .\\pathfinder --clear-cache" << std::endl;
     std::cout << "\nOptions:" << std::endl;
     std::cout << "  --test-path <dir>  Specify the test case directory (required)" << std::endl;
     std::cout << "  --no-cache         Disable cache and force recalculation (optional)" << std::endl;
+    std::cout << "  --cache-policy <p> Cache eviction policy: lru (default) or tinylfu (frequency, compute cost and size aware) (optional)" << std::endl;
+    std::cout << "  --content-keys     Key cached paths by map file content (XXH64) instead of path and mtime (optional)" << std::endl;
+    std::cout << "  --tree-cache       With --serve: keep full shortest-path trees per origin; repeated origins need no search (optional)" << std::endl;
+    std::cout << "  --algorithm <name> Search algorithm: dijkstra (default), bidirectional, alt, ch, crp or dynamic (optional)" << std::endl;
+    std::cout << "  --queue <name>     Priority queue for dijkstra/bidirectional: binary, dary (default) or radix (optional)" << std::endl;
+    std::cout << "  --reachability     Index strongly connected components on load; unreachable queries return instantly (optional)" << std::endl;
+    std::cout << "  --benchmark        Compare query time of all priority queues instead of printing paths (optional)" << std::endl;
+    std::cout << "  --matrix <file>    Write a travel-time/distance matrix (every 起点 x every 终点 in the demand file) per map (optional)" << std::endl;
+    std::cout << "  --matrix-mode <m>  Weight mode used to pick matrix paths: time (default), distance or balanced (optional)" << std::endl;
+    std::cout << "  --jobs <n>         Process map snapshots on n worker threads, output stays in snapshot order (optional, default 1)" << std::endl;
+    std::cout << "  --batch            Answer every 起点/终点 pair in the demand file, one shared search per origin (optional)" << std::endl;
+    std::cout << "  --serve <socket>   Run as a resident server on a Unix domain socket (query/reload/stats/quit, one request per line)" << std::endl;
     std::cout << "  --clear-cache      Clear all cached results and exit" << std::endl;
     std::cout << "\nExamples:" << std::endl;
     std::cout << "  .\\pathfinder --test-path Test_Cases/test_cases/shanghai_test_cases/case1_simple" << std::endl;
     std::cout << "  .\\pathfinder --test-path Test_Cases/test_cases/shanghai_test_cases/case1_simple --no-cache" << std::endl;
+    std::cout << "  .\\pathfinder --test-path Test_Cases/large_scale_cases/large_scale_case_example --no-cache --algorithm bidirectional" << std::endl;
+    std::cout << "  .\\pathfinder --test-path Test_Cases/large_scale_cases/large_scale_case_example --benchmark" << std::endl;
     std::cout << "  .\\pathfinder --clear-cache" << std::endl;
 }
 
 // 打印单条路径（带装饰边框）
-void print_single_path(const std::string &title, const PathResult &result)
+void print_single_path(const std::string &title, const PathResult &result, std::ostream &out)
 {
-    std::cout << "\n┌─ " << title << " ──────────────────────────────────────────" << std::endl;
+    out << "\n┌─ " << title << " ──────────────────────────────────────────" << std::endl;
     if (!result.path.empty())
     {
-        std::cout << "│ Path: ";
+        out << "│ Path: ";
         for (size_t i = 0; i < result.path.size(); ++i)
         {
-            std::cout << result.path[i] << (i == result.path.size() - 1 ? "" : " --> ");
+            out << result.path[i] << (i == result.path.size() - 1 ? "" : " --> ");
         }
-        std::cout << std::endl;
-        std::cout << "│ Total Time: " << result.time << " seconds" << std::endl;
-        std::cout << "│ Total Distance: " << result.distance << " meters" << std::endl;
+        out << std::endl;
+        out << "│ Total Time: " << result.time << " seconds" << std::endl;
+        out << "│ Total Distance: " << result.distance << " meters" << std::endl;
     }
     else
     {
-        std::cout << "│ No path found." << std::endl;
+        out << "│ No path found." << std::endl;
     }
-    std::cout << "└─────────────────────────────────────────────────────" << std::endl;
+    out << "└─────────────────────────────────────────────────────" << std::endl;
 }
 
 // 打印所有三种路径
-void print_multi_paths(const MultiPath &paths)
+void print_multi_paths(const MultiPath &paths, std::ostream &out)
+{
+    print_single_path("时间最短", paths.time_path, out);
+    print_single_path("距离最短", paths.distance_path, out);
+    print_single_path("综合推荐", paths.balanced_path, out);
+    out << "\n";
+}
+
+// 打印本次搜索的统计信息（算法、各模式确定的节点数、总耗时）
+void print_search_statistics(const MultiPath &paths, double elapsed_ms, std::ostream &out)
 {
-    print_single_path("时间最短", paths.time_path);
-    print_single_path("距离最短", paths.distance_path);
-    print_single_path("综合推荐", paths.balanced_path);
-    std::cout << "\n";
+    out << "[Search] Algorithm: " << search_algorithm_name(SearchConfig::algorithm)
+        << ", settled nodes (time/distance/balanced): "
+        << paths.time_path.settled_nodes << "/"
+        << paths.distance_path.settled_nodes << "/"
+        << paths.balanced_path.settled_nodes
+        << ", elapsed: " << elapsed_ms << " ms" << std::endl;
 }
 
 // 打印缓存统计信息
@@ -156,6 +500,18 @@ void print_cache_statistics(PathCache *cache)
     std::cout << "  Hits: " << cache->get_hit_count() << std::endl;
     std::cout << "  Misses: " << cache->get_miss_count() << std::endl;
     std::cout << "  Entries: " << cache->get_entry_count() << std::endl;
+
+    size_t lookups = cache->get_hit_count() + cache->get_miss_count();
+    double hit_rate = lookups == 0 ? 0.0 : 100.0 * cache->get_hit_count() / lookups;
+    std::cout << "  Hit rate: " << hit_rate << "%" << std::endl;
+    std::cout << "  Bytes saved: " << cache->get_bytes_saved() << std::endl;
+    std::cout << "  Compute saved: " << cache->get_compute_saved_ms() << " ms" << std::endl;
+    std::cout << "  Policy: " << cache_policy_name(cache->get_policy());
+    if (cache->get_policy() == CachePolicy::TINY_LFU)
+    {
+        std::cout << " (rejected: " << cache->get_rejected_count() << ")";
+    }
+    std::cout << std::endl;
     std::cout << "========================================================" << std::endl;
 }
 
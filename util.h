@@ -1,8 +1,10 @@
 #ifndef UTIL_H
 #define UTIL_H
 
+#include <iostream>
 #include <string>
 #include <vector>
+#include <utility>
 #include <filesystem>
 #include "Cache.h"
 
@@ -20,10 +22,45 @@ bool find_test_files(const std::filesystem::path &case_path,
 
 bool read_demand(const std::string &filename, std::string &start, std::string &end);
 
-// 输出工具函数
+// 读取距离矩阵的起点和终点：demand文件中每一行"起点："都是一个起点，每一行"终点："都是一个终点
+bool read_matrix_demand(const std::string &filename, std::vector<std::string> &sources, std::vector<std::string> &targets);
+
+// 读取批量请求：demand文件中按顺序成对出现的"起点："和"终点："各组成一个请求
+// 缺少终点的起点或缺少起点的终点会输出警告并跳过
+bool read_batch_demand(const std::string &filename, std::vector<std::pair<std::string, std::string>> &requests);
+
+// 保存距离矩阵：扩展名为.bin时写二进制格式，否则写CSV（每个起终点对一行）
+bool write_distance_matrix(const DistanceMatrix &matrix, const std::string &filename);
+
+// 解析搜索算法名称（dijkstra/bidirectional/alt/ch/crp/dynamic），成功返回true
+bool parse_search_algorithm(const std::string &name, SearchAlgorithm &algorithm);
+
+// 获取搜索算法的名称
+std::string search_algorithm_name(SearchAlgorithm algorithm);
+
+// 解析权重模式名称（time/distance/balanced），成功返回true
+bool parse_weight_mode(const std::string &name, WeightMode &mode);
+
+// 解析优先队列名称（binary/dary/radix），成功返回true
+bool parse_queue_type(const std::string &name, QueueType &queue);
+
+// 获取优先队列的名称
+std::string queue_type_name(QueueType queue);
+
+// 解析缓存淘汰策略名称（lru/tinylfu），成功返回true
+bool parse_cache_policy(const std::string &name, CachePolicy &policy);
+
+// 获取缓存淘汰策略的名称
+std::string cache_policy_name(CachePolicy policy);
+
+// 解析并行处理快照的线程数（正整数），成功返回true
+bool parse_job_count(const std::string &text, size_t &jobs);
+
+// 输出工具函数（out默认为标准输出，并行处理快照时写入各快照自己的缓冲区）
 void print_usage();
-void print_single_path(const std::string &title, const PathResult &result);
-void print_multi_paths(const MultiPath &paths);
+void print_single_path(const std::string &title, const PathResult &result, std::ostream &out = std::cout);
+void print_multi_paths(const MultiPath &paths, std::ostream &out = std::cout);
+void print_search_statistics(const MultiPath &paths, double elapsed_ms, std::ostream &out = std::cout);
 void print_cache_statistics(PathCache *cache);
 
 // BPR拥堵函数